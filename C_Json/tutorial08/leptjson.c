@@ -479,6 +479,8 @@ void lept_copy(lept_value* dst, const lept_value* src) {
 			lept_set_array(dst, src->u.a.size);
 			// 逐个拷贝
 			for (i = 0; i < src->u.a.size; i++) {
+				// 新分配的元素未初始化，lept_copy 会先释放目标，因此要先初始化为 null
+				lept_init(&dst->u.a.e[i]);
 				lept_copy(&dst->u.a.e[i], &src->u.a.e[i]);
 			}
 			// 再设置大小
@@ -0,0 +1,24 @@
+#ifndef MINIJSON_BENCH_ADAPTER_H__
+#define MINIJSON_BENCH_ADAPTER_H__
+
+#include <cstddef>
+
+/*
+    对比测试中的一种 json 实现：通过一组函数指针统一调用 C 教程各课的 leptjson 以及 C++ 的 yfn::Json。
+    某一课还没有实现的操作对应的函数指针为 nullptr。
+*/
+struct BenchAdapter
+{
+    const char *name;
+    void* (*create)();
+    void (*destroy)(void *doc);
+    /* 解析以 '\0' 结尾的 json 文本，之前解析的结果先释放；失败或不支持时返回 false */
+    bool (*parse)(void *doc, const char *json, size_t len);
+    /* 序列化，返回生成的字节数 */
+    size_t (*stringify)(const void *doc);
+    /* 深拷贝一份然后释放 */
+    void (*copy)(const void *doc);
+    bool (*equal)(const void *lhs, const void *rhs);
+};
+
+#endif
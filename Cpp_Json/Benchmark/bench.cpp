@@ -0,0 +1,227 @@
+/*
+    MiniJsonBench：在本地生成的三种典型语料（twitter、canada、citm，见 corpus.h）上测量解析、序列化、深拷贝、比较与按 key 查找的性能。
+    每项结果输出 MB/s、ns/node 以及每个文档的内存分配次数，用于发现性能回退。
+    用法：MiniJsonBench [语料名过滤] [--min-time=秒] [--simd=scalar|sse2|sse4.2|avx2|avx512]
+*/
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+#include "../Source/include/json.h"
+#include "../Source/include/jsonDocument.h"
+#include "../Source/include/jsonHandler.h"
+#include "../Source/include/jsonPushParser.h"
+#include "../Source/include/jsonSink.h"
+#include "corpus.h"
+#include "harness.h"
+
+using namespace yfn;
+
+/* 通过替换全局 operator new 统计内存分配次数 */
+void* operator new(size_t size)
+{
+    ++alloc_count;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t align)
+{
+    ++alloc_count;
+    if (void *p = std::aligned_alloc(static_cast<size_t>(align), (size + static_cast<size_t>(align) - 1) & ~(static_cast<size_t>(align) - 1)))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+/* 统计树中的节点个数 */
+static size_t count_nodes(JsonView v)
+{
+    size_t n = 1;
+    if (v.get_type() == json::Array)
+        for (JsonView e : v)
+            n += count_nodes(e);
+    else if (v.get_type() == json::Object)
+        for (json::Member m : v.members())
+            n += count_nodes(m.value);
+    return n;
+}
+
+/* 收集树中每个对象的每个 key，用于测量按 key 查找 */
+struct Lookup
+{
+    JsonView object;
+    std::string_view key;
+};
+
+static void collect_lookups(JsonView v, std::vector<Lookup> &lookups)
+{
+    if (v.get_type() == json::Array)
+        for (JsonView e : v)
+            collect_lookups(e, lookups);
+    else if (v.get_type() == json::Object) {
+        for (json::Member m : v.members()) {
+            lookups.push_back(Lookup{ v, m.key });
+            collect_lookups(m.value, lookups);
+        }
+    }
+}
+
+static void report(const char *corpus, const char *op, size_t bytes, size_t nodes, const Stat &st)
+{
+    printf("%-8s %-18s %10.1f MB/s %10.2f ns/node %12.1f allocs/doc\n",
+           corpus, op, bytes / st.seconds / 1e6, st.seconds * 1e9 / nodes, st.allocs);
+}
+
+static void bench_corpus(const char *name, const std::string &content)
+{
+    Json j;
+    j.parse(content);
+    size_t nodes = count_nodes(j.view());
+    printf("%-8s %zu bytes, %zu nodes, %zu bytes in memory\n", name, content.size(), nodes, j.memory_usage());
+
+    report(name, "parse", content.size(), nodes, run([&] {
+        Json t;
+        t.parse(content);
+    }));
+
+    Document doc;
+    report(name, "parse (Document)", content.size(), nodes, run([&] {
+        doc.parse(content);
+    }));
+
+    // 先用 SIMD 建立结构索引再沿着索引解析
+    json::ParseOptions structural;
+    structural.engine = json::ParseEngine::Structural;
+    report(name, "parse (structural)", content.size(), nodes, run([&] {
+        Json t;
+        t.parse(content, structural);
+    }));
+    report(name, "Document (struct.)", content.size(), nodes, run([&] {
+        doc.parse(content, structural);
+    }));
+
+    // 只产生事件、不构建树的解析，即词法与语法分析本身的开销
+    json::Handler ignore;
+    report(name, "parse (SAX)", content.size(), nodes, run([&] {
+        json::parse(content, ignore);
+    }));
+    report(name, "SAX (structural)", content.size(), nodes, run([&] {
+        json::parse(content, ignore, structural);
+    }));
+
+    // 严格校验 UTF-8：与解析融合在一起，以及单独校验一遍
+    json::ParseOptions strict;
+    strict.validate_utf8 = true;
+    report(name, "SAX (UTF-8)", content.size(), nodes, run([&] {
+        json::parse(content, ignore, strict);
+    }));
+    report(name, "validate UTF-8", content.size(), nodes, run([&] {
+        json::validate_utf8(content);
+    }));
+
+    // 按 4 KB 的块增量解析，模拟从网络上逐块接收
+    report(name, "parse (push 4K)", content.size(), nodes, run([&] {
+        Json t;
+        json::PushParser parser(t);
+        for (size_t i = 0; i < content.size(); i += 4096)
+            parser.feed(content.data() + i, std::min<size_t>(4096, content.size() - i));
+        parser.finish();
+    }));
+
+    std::string out;
+    out.reserve(content.size() * 2);
+    report(name, "stringify", content.size(), nodes, run([&] {
+        j.stringify(out);
+    }));
+
+    // 先算出精确长度再生成：每次都从空字符串开始，对比逐步扩容的开销
+    json::StringifyOptions exact;
+    exact.exact_size = true;
+    report(name, "stringify (grow)", content.size(), nodes, run([&] {
+        std::string s;
+        j.stringify(s);
+    }));
+    report(name, "stringify (exact)", content.size(), nodes, run([&] {
+        std::string s;
+        j.stringify(s, exact);
+    }));
+    size_t total_size = 0;
+    report(name, "serialized_size", content.size(), nodes, run([&] {
+        total_size += j.serialized_size();
+    }));
+
+    // 流式生成到一个只统计字节数的 sink，峰值内存只有一个固定大小的缓冲区
+    size_t streamed = 0;
+    json::CallbackSink sink([&](const char *, size_t len) { streamed += len; return true; });
+    report(name, "stringify (sink)", content.size(), nodes, run([&] {
+        j.stringify(sink);
+    }));
+
+    report(name, "copy", content.size(), nodes, run([&] {
+        Json copy = j;
+    }));
+
+    Json other;
+    other.parse(content);
+    bool equal = true;
+    report(name, "equal", content.size(), nodes, run([&] {
+        equal = equal && (j == other);
+    }));
+
+    std::vector<Lookup> lookups;
+    collect_lookups(j.view(), lookups);
+    long long checksum = 0;
+    Stat st = run([&] {
+        for (const Lookup &l : lookups)
+            checksum += l.object.find_object_index(l.key);
+    });
+    printf("%-8s %-18s %10.2f ns/lookup %9zu lookups %10.1f allocs/doc\n",
+           name, "lookup", st.seconds * 1e9 / (lookups.empty() ? 1 : lookups.size()), lookups.size(), st.allocs);
+
+    if (!equal || checksum < 0 || streamed % out.size() != 0 || total_size % out.size() != 0)
+        printf("%-8s unexpected result\n", name);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *filter = "";
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--min-time=", 11) == 0)
+            min_time = atof(argv[i] + 11);
+        else if (strncmp(argv[i], "--simd=", 7) == 0) {
+            if (!json::set_simd_level(argv[i] + 7)) {
+                fprintf(stderr, "SIMD level %s is not available\n", argv[i] + 7);
+                return 1;
+            }
+        }
+        else
+            filter = argv[i];
+    }
+    printf("SIMD level: %s\n", json::simd_level());
+
+    struct Corpus
+    {
+        const char *name;
+        std::string (*make)();
+    };
+    const Corpus corpora[] = {
+        { "twitter", [] { return make_twitter(800); } },
+        { "canada",  [] { return make_canada(120, 500); } },
+        { "citm",    [] { return make_citm(2000, 3000); } },
+    };
+    for (const Corpus &c : corpora) {
+        if (strstr(c.name, filter) == nullptr)
+            continue;
+        bench_corpus(c.name, c.make());
+    }
+    return 0;
+}
@@ -0,0 +1,138 @@
+/*
+    MiniJsonCompareBench：在相同的语料上对比 C 教程 03~08 各课的 leptjson 与 C++ 的 yfn::Json、yfn::Document，
+    输出解析、序列化、深拷贝与比较的吞吐量（按输入的字节数计算 MB/s）。
+    n/a 表示该实现还不支持这种语料（例如 05 之前没有数组、06 之前没有对象）或者还没有这项操作。
+    用法：MiniJsonCompareBench [语料名过滤] [--min-time=秒]
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "../Source/include/json.h"
+#include "../Source/include/jsonDocument.h"
+#include "adapter.h"
+#include "corpus.h"
+#include "harness.h"
+
+using namespace yfn;
+
+extern const BenchAdapter lept03_bench_adapter;
+extern const BenchAdapter lept04_bench_adapter;
+extern const BenchAdapter lept05_bench_adapter;
+extern const BenchAdapter lept06_bench_adapter;
+extern const BenchAdapter lept07_bench_adapter;
+extern const BenchAdapter lept08_bench_adapter;
+
+/* yfn::Json */
+static std::string stringify_buffer;
+
+static const BenchAdapter json_adapter = {
+    "yfn::Json",
+    [] () -> void* { return new Json; },
+    [] (void *doc) { delete static_cast<Json*>(doc); },
+    [] (void *doc, const char *json, size_t len) { return bool(static_cast<Json*>(doc)->try_parse(json, len)); },
+    [] (const void *doc) { static_cast<const Json*>(doc)->stringify(stringify_buffer); return stringify_buffer.size(); },
+    [] (const void *doc) { Json copy(*static_cast<const Json*>(doc)); },
+    [] (const void *lhs, const void *rhs) { return *static_cast<const Json*>(lhs) == *static_cast<const Json*>(rhs); },
+};
+
+/* yfn::Document：解析结果放在内存池中，拷贝即 to_json() */
+static const BenchAdapter document_adapter = {
+    "yfn::Document",
+    [] () -> void* { return new Document; },
+    [] (void *doc) { delete static_cast<Document*>(doc); },
+    [] (void *doc, const char *json, size_t len) { return bool(static_cast<Document*>(doc)->parse(json, len)); },
+    [] (const void *doc) { static_cast<const Document*>(doc)->stringify(stringify_buffer); return stringify_buffer.size(); },
+    [] (const void *doc) { Json copy = static_cast<const Document*>(doc)->to_json(); },
+    [] (const void *lhs, const void *rhs) { return static_cast<const Document*>(lhs)->view() == static_cast<const Document*>(rhs)->view(); },
+};
+
+static const BenchAdapter *const adapters[] = {
+    &lept03_bench_adapter, &lept04_bench_adapter, &lept05_bench_adapter,
+    &lept06_bench_adapter, &lept07_bench_adapter, &lept08_bench_adapter,
+    &json_adapter, &document_adapter,
+};
+static const size_t adapter_count = sizeof(adapters) / sizeof(adapters[0]);
+
+enum Op { OpParse, OpStringify, OpCopy, OpEqual, OpCount };
+static const char *const op_names[OpCount] = { "parse", "stringify", "copy", "equal" };
+
+/* 测量一种实现在一份语料上的各项操作，返回 MB/s，不支持时为负数 */
+static void measure(const BenchAdapter &a, const std::string &content, double (&mbps)[OpCount])
+{
+    for (double &m : mbps)
+        m = -1;
+    void *doc = a.create();
+    void *other = a.create();
+    if (a.parse(doc, content.c_str(), content.size()) && a.parse(other, content.c_str(), content.size())) {
+        double bytes = double(content.size());
+        mbps[OpParse] = bytes / run([&] { a.parse(doc, content.c_str(), content.size()); }).seconds / 1e6;
+        if (a.stringify)
+            mbps[OpStringify] = bytes / run([&] { a.stringify(doc); }).seconds / 1e6;
+        if (a.copy)
+            mbps[OpCopy] = bytes / run([&] { a.copy(doc); }).seconds / 1e6;
+        if (a.equal) {
+            bool equal = true;
+            mbps[OpEqual] = bytes / run([&] { equal = equal && a.equal(doc, other); }).seconds / 1e6;
+            if (!equal)
+                mbps[OpEqual] = -1;
+        }
+    }
+    a.destroy(other);
+    a.destroy(doc);
+}
+
+static void compare_corpus(const char *name, const std::string &content)
+{
+    std::vector<double> results(adapter_count * OpCount);
+    for (size_t i = 0; i < adapter_count; ++i)
+        measure(*adapters[i], content, *reinterpret_cast<double(*)[OpCount]>(&results[i * OpCount]));
+
+    printf("\n%s (%zu bytes), MB/s\n%-10s", name, content.size(), "");
+    for (const BenchAdapter *a : adapters)
+        printf(" %13s", a->name);
+    printf("\n");
+    for (int op = 0; op < OpCount; ++op) {
+        printf("%-10s", op_names[op]);
+        for (size_t i = 0; i < adapter_count; ++i) {
+            double m = results[i * OpCount + op];
+            if (m < 0)
+                printf(" %13s", "n/a");
+            else
+                printf(" %13.1f", m);
+        }
+        printf("\n");
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const char *filter = "";
+    min_time = 0.2;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--min-time=", 11) == 0)
+            min_time = atof(argv[i] + 11);
+        else
+            filter = argv[i];
+    }
+
+    struct Corpus
+    {
+        const char *name;
+        std::string (*make)();
+    };
+    const Corpus corpora[] = {
+        { "strings", [] { return make_strings(200000); } },
+        { "arrays",  [] { return make_arrays(120, 500); } },
+        { "twitter", [] { return make_twitter(800); } },
+        { "canada",  [] { return make_canada(120, 500); } },
+        { "citm",    [] { return make_citm(2000, 3000); } },
+    };
+    for (const Corpus &c : corpora) {
+        if (strstr(c.name, filter) == nullptr)
+            continue;
+        compare_corpus(c.name, c.make());
+    }
+    return 0;
+}
@@ -0,0 +1,183 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include "../Source/include/json.h"
+#include "../Source/include/jsonDocument.h"
+
+using namespace yfn;
+
+/* 通过替换全局 operator new 统计内存分配次数：每次深拷贝字符串或数组都会产生一次分配 */
+static size_t alloc_count = 0;
+
+void* operator new(size_t size)
+{
+    ++alloc_count;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+/* std::pmr 的默认内存资源调用的是带对齐参数的版本 */
+void* operator new(size_t size, std::align_val_t align)
+{
+    ++alloc_count;
+    if (void *p = std::aligned_alloc(static_cast<size_t>(align), (size + static_cast<size_t>(align) - 1) & ~(static_cast<size_t>(align) - 1)))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+struct Result
+{
+    size_t allocs;
+    double ms;
+};
+
+template <typename F>
+static Result measure(F f)
+{
+    size_t before = alloc_count;
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return { alloc_count - before, std::chrono::duration<double, std::milli>(end - start).count() };
+}
+
+static void report(const char *name, size_t nodes, const Result &r)
+{
+    printf("%-28s nodes=%-8zu allocs=%-10zu allocs/node=%-8.2f time=%.2f ms\n",
+           name, nodes, r.allocs, double(r.allocs) / nodes, r.ms);
+}
+
+/*
+    逐个把带字符串的小对象压入数组：移动语义下既不拷贝元素，也不在扩容时深拷贝已有元素，
+    字符串直接在 json::default_resource() 上构造后移入。Release 构建下 300000 个节点约 700019 次分配
+*/
+static void bench_build_array(size_t n)
+{
+    Result r = measure([n] {
+        Json arr;
+        arr.set_array();
+        for (size_t i = 0; i < n; ++i) {
+            Json obj, name, id;
+            obj.set_object();
+            std::pmr::string str("a string long enough to defeat sso #", json::default_resource());
+            str += std::to_string(i);
+            name.set_string(std::move(str));
+            id.set_number(static_cast<double>(i));
+            obj.set_object_value("name", std::move(name));
+            obj.set_object_value("id", std::move(id));
+            arr.pushback_array_element(std::move(obj));
+        }
+    });
+    report("build array of objects", n * 3, r);
+}
+
+/* 构造 depth 层嵌套的数组，每一层都压入上一层：拷贝语义下代价为 O(depth^2) */
+static void bench_build_nested(size_t depth)
+{
+    Result r = measure([depth] {
+        Json cur;
+        cur.set_string("a string long enough to defeat sso");
+        for (size_t i = 0; i < depth; ++i) {
+            Json parent;
+            parent.set_array();
+            parent.pushback_array_element(std::move(cur));
+            cur = std::move(parent);
+        }
+    });
+    report("build nested arrays", depth, r);
+}
+
+/* 解析嵌套文档 */
+static void bench_parse_nested(size_t depth, size_t width)
+{
+    std::string content;
+    for (size_t i = 0; i < depth; ++i)
+        content += "[\"a string long enough to defeat sso\",";
+    content += "[";
+    for (size_t i = 0; i < width; ++i)
+        content += i ? ",1" : "1";
+    content += "]";
+    for (size_t i = 0; i < depth; ++i)
+        content += "]";
+
+    Result r = measure([&content] {
+        Json j;
+        j.parse(content);
+    });
+    report("parse nested arrays", depth * 2 + width, r);
+}
+
+/* 反复解析同一类消息：Json 每次都要逐个节点分配与释放，Document 预热之后全部从内存池中分配 */
+static void bench_parse_messages(size_t count)
+{
+    std::string message = "{\"id\":12345,\"user\":{\"name\":\"a string long enough to defeat sso\",\"tags\":[\"alpha\",\"beta\",\"gamma\"]},"
+                          "\"values\":[1.5,2.5,3.5,4.5,5.5,6.5,7.5,8.5],\"text\":\"another string long enough to defeat sso\"}";
+    size_t nodes = 20;
+
+    Result r = measure([&] {
+        Json j;
+        for (size_t i = 0; i < count; ++i)
+            j.parse(message);
+    });
+    report("parse messages (Json)", nodes * count, r);
+
+    Document doc;
+    doc.parse(message); // 预热：让内存池申请好足够的内存块
+    r = measure([&] {
+        for (size_t i = 0; i < count; ++i)
+            doc.parse(message);
+    });
+    report("parse messages (Document)", nodes * count, r);
+}
+
+/* 遍历大数组：Json 的 getter 每次都要分配并深拷贝一个元素，JsonView 只是移动指针 */
+static void bench_walk_array(size_t n)
+{
+    Json arr;
+    arr.set_array();
+    for (size_t i = 0; i < n; ++i) {
+        Json s;
+        s.set_string("a string long enough to defeat sso");
+        arr.pushback_array_element(std::move(s));
+    }
+
+    size_t total = 0;
+    Result r = measure([&] {
+        for (size_t i = 0, size = arr.get_array_size(); i < size; ++i)
+            total += arr.get_array_element(i).get_string().size();
+    });
+    report("walk array (Json getters)", n, r);
+
+    r = measure([&] {
+        JsonView view = arr.view();
+        for (size_t i = 0, size = view.get_array_size(); i < size; ++i)
+            total += view.get_array_element(i).get_string().size();
+    });
+    report("walk array (JsonView)", n, r);
+
+    r = measure([&] {
+        for (JsonView e : arr)
+            total += e.get_string().size();
+    });
+    report("walk array (range-for)", n, r);
+    if (total == 0)
+        printf("unexpected\n");
+}
+
+int main()
+{
+    bench_build_array(100000);
+    bench_build_nested(2000);
+    bench_parse_nested(500, 1000);
+    bench_parse_messages(100000);
+    bench_walk_array(1000000);
+    return 0;
+}
@@ -0,0 +1,185 @@
+#ifndef MINIJSON_BENCH_CORPUS_H__
+#define MINIJSON_BENCH_CORPUS_H__
+
+/*
+    基准测试用的语料：由固定种子的伪随机数在本地生成，不需要下载，每次生成的内容完全相同。
+        twitter  —— 字符串较多、带 unicode 的对象数组
+        canada   —— 大量高精度浮点数组成的坐标数组
+        citm     —— 以数字 id 为 key 的大对象以及多层嵌套
+        strings  —— 一个只含简单转义的长字符串（C 教程 03 起即可解析）
+        arrays   —— 只由数组与数字组成的坐标（C 教程 05 起即可解析）
+*/
+#include <cstdio>
+#include <string>
+
+/* 固定种子的伪随机数，保证每次生成的语料完全相同 */
+class Random
+{
+public:
+    explicit Random(unsigned long long seed) : state_(seed) { }
+    unsigned long long next()
+    {
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 7;
+        state_ ^= state_ << 17;
+        return state_;
+    }
+    size_t uniform(size_t n) { return static_cast<size_t>(next() % n); }
+    double real() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+private:
+    unsigned long long state_;
+};
+
+inline std::string random_word(Random &rng, size_t min_len, size_t max_len)
+{
+    static const char letters[] = "abcdefghijklmnopqrstuvwxyz";
+    std::string s;
+    for (size_t i = 0, n = min_len + rng.uniform(max_len - min_len + 1); i < n; ++i)
+        s += letters[rng.uniform(26)];
+    return s;
+}
+
+inline std::string random_text(Random &rng, size_t words)
+{
+    static const char *const extras[] = { " \\u3053\\u3093\\u306b\\u3061\\u306f", " caf\xc3\xa9", " \\\"quoted\\\"", " line\\nbreak", " #tag", " @user", " \xe2\x9c\x93" };
+    std::string s;
+    for (size_t i = 0; i < words; ++i) {
+        if (i) s += ' ';
+        s += random_word(rng, 2, 9);
+        if (rng.uniform(6) == 0)
+            s += extras[rng.uniform(sizeof(extras) / sizeof(extras[0]))];
+    }
+    return s;
+}
+
+/* twitter：字符串为主的推文对象数组 */
+inline std::string make_twitter(size_t count)
+{
+    Random rng(1);
+    std::string s = "{\"statuses\":[";
+    for (size_t i = 0; i < count; ++i) {
+        if (i) s += ',';
+        unsigned long long id = 505874924095815681ULL + rng.uniform(1000000000);
+        std::string name = random_word(rng, 4, 12);
+        s += "{\"metadata\":{\"result_type\":\"recent\",\"iso_language_code\":\"ja\"},";
+        s += "\"created_at\":\"Sun Aug 31 00:29:15 +0000 2014\",";
+        s += "\"id\":" + std::to_string(id) + ",\"id_str\":\"" + std::to_string(id) + "\",";
+        s += "\"text\":\"" + random_text(rng, 8 + rng.uniform(16)) + "\",";
+        s += "\"source\":\"<a href=\\\"http://twitter.com/download/iphone\\\" rel=\\\"nofollow\\\">Twitter for iPhone</a>\",";
+        s += "\"truncated\":false,\"in_reply_to_status_id\":null,\"in_reply_to_user_id\":null,";
+        s += "\"user\":{\"id\":" + std::to_string(rng.uniform(3000000000ULL)) + ",\"name\":\"" + name + "\",";
+        s += "\"screen_name\":\"" + name + "_" + std::to_string(rng.uniform(1000)) + "\",\"location\":\"\",";
+        s += "\"description\":\"" + random_text(rng, 4 + rng.uniform(12)) + "\",\"url\":null,";
+        s += "\"protected\":false,\"followers_count\":" + std::to_string(rng.uniform(100000)) + ",";
+        s += "\"friends_count\":" + std::to_string(rng.uniform(5000)) + ",\"listed_count\":" + std::to_string(rng.uniform(100)) + ",";
+        s += "\"verified\":false,\"lang\":\"ja\",\"profile_background_color\":\"C0DEED\",\"default_profile\":true},";
+        s += "\"geo\":null,\"coordinates\":null,\"place\":null,\"contributors\":null,";
+        s += "\"retweet_count\":" + std::to_string(rng.uniform(500)) + ",\"favorite_count\":" + std::to_string(rng.uniform(500)) + ",";
+        s += "\"entities\":{\"hashtags\":[";
+        for (size_t h = 0, n = rng.uniform(3); h < n; ++h) {
+            if (h) s += ',';
+            size_t at = rng.uniform(100);
+            s += "{\"text\":\"" + random_word(rng, 3, 10) + "\",\"indices\":[" + std::to_string(at) + "," + std::to_string(at + 8) + "]}";
+        }
+        s += "],\"symbols\":[],\"urls\":[],\"user_mentions\":[]},";
+        s += "\"favorited\":false,\"retweeted\":false,\"lang\":\"ja\"}";
+    }
+    s += "],\"search_metadata\":{\"completed_in\":0.087,\"max_id\":505874924095815681,\"count\":" + std::to_string(count) + "}}";
+    return s;
+}
+
+/* canada：GeoJSON 形式的多边形，坐标是大量高精度浮点数 */
+inline std::string make_canada(size_t rings, size_t points)
+{
+    Random rng(2);
+    char buffer[64];
+    std::string s = "{\"type\":\"FeatureCollection\",\"features\":[{\"type\":\"Feature\",\"properties\":{\"name\":\"Canada\"},"
+                    "\"geometry\":{\"type\":\"Polygon\",\"coordinates\":[";
+    for (size_t r = 0; r < rings; ++r) {
+        if (r) s += ',';
+        s += '[';
+        double lon = -141.0 + rng.real() * 90.0, lat = 42.0 + rng.real() * 40.0;
+        for (size_t p = 0; p < points; ++p) {
+            if (p) s += ',';
+            lon += (rng.real() - 0.5) * 0.01;
+            lat += (rng.real() - 0.5) * 0.01;
+            snprintf(buffer, sizeof(buffer), "[%.15g,%.15g]", lon, lat);
+            s += buffer;
+        }
+        s += ']';
+    }
+    s += "]}}]}";
+    return s;
+}
+
+/* citm：以数字 id 为 key 的大对象、多层嵌套的小对象与整数数组 */
+inline std::string make_citm(size_t events, size_t performances)
+{
+    Random rng(3);
+    std::string s = "{\"areaNames\":{";
+    for (size_t i = 0; i < 20; ++i) {
+        if (i) s += ',';
+        s += "\"" + std::to_string(205705993 + i) + "\":\"" + random_word(rng, 5, 20) + "\"";
+    }
+    s += "},\"events\":{";
+    for (size_t i = 0; i < events; ++i) {
+        if (i) s += ',';
+        std::string id = std::to_string(138586341 + i * 3);
+        s += "\"" + id + "\":{\"description\":null,\"id\":" + id + ",\"logo\":";
+        s += rng.uniform(3) ? "null" : "\"/images/UE0AAAAACEKo6QAAAAZDSVRN\"";
+        s += ",\"name\":\"" + random_word(rng, 6, 24) + "\",\"subTopicIds\":[";
+        for (size_t t = 0, n = 1 + rng.uniform(5); t < n; ++t) {
+            if (t) s += ',';
+            s += std::to_string(337184262 + rng.uniform(100));
+        }
+        s += "],\"subjectCode\":null,\"subtitle\":null,\"topicIds\":[" + std::to_string(324846099 + rng.uniform(10)) + "]}";
+    }
+    s += "},\"performances\":[";
+    for (size_t i = 0; i < performances; ++i) {
+        if (i) s += ',';
+        s += "{\"eventId\":" + std::to_string(138586341 + rng.uniform(events) * 3) + ",\"id\":" + std::to_string(339887544 + i) + ",";
+        s += "\"logo\":null,\"name\":null,\"prices\":[";
+        for (size_t p = 0, n = 1 + rng.uniform(4); p < n; ++p) {
+            if (p) s += ',';
+            s += "{\"amount\":" + std::to_string(10000 + rng.uniform(90000)) + ",\"audienceSubCategoryId\":337100890,\"seatCategoryId\":" + std::to_string(338937295 + p) + "}";
+        }
+        s += "],\"seatCategories\":[";
+        for (size_t c = 0, n = 1 + rng.uniform(4); c < n; ++c) {
+            if (c) s += ',';
+            s += "{\"areas\":[";
+            for (size_t a = 0, m = 1 + rng.uniform(6); a < m; ++a) {
+                if (a) s += ',';
+                s += "{\"areaId\":" + std::to_string(205705993 + rng.uniform(20)) + ",\"blockIds\":[]}";
+            }
+            s += "],\"seatCategoryId\":" + std::to_string(338937295 + c) + "}";
+        }
+        s += "],\"seatMapImage\":null,\"start\":" + std::to_string(1372701600000ULL + i * 86400000ULL) + ",\"venueCode\":\"PLEYEL_PLEYEL\"}";
+    }
+    s += "],\"venueNames\":{\"PLEYEL_PLEYEL\":\"Salle Pleyel\"}}";
+    return s;
+}
+
+/* strings：一个很长的字符串，只含 \n、\" 这类简单转义，不含 \u */
+inline std::string make_strings(size_t words)
+{
+    Random rng(4);
+    std::string s = "\"";
+    for (size_t i = 0; i < words; ++i) {
+        if (i) s += ' ';
+        s += random_word(rng, 2, 9);
+        if (rng.uniform(8) == 0)
+            s += rng.uniform(2) ? "\\n" : "\\\"";
+    }
+    s += '\"';
+    return s;
+}
+
+/* arrays：canada 的坐标部分，只有嵌套数组与数字 */
+inline std::string make_arrays(size_t rings, size_t points)
+{
+    std::string s = make_canada(rings, points);
+    size_t begin = s.find("\"coordinates\":") + 14;
+    return s.substr(begin, s.size() - 4 - begin);
+}
+
+#endif
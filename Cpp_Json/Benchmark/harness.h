@@ -0,0 +1,41 @@
+#ifndef MINIJSON_BENCH_HARNESS_H__
+#define MINIJSON_BENCH_HARNESS_H__
+
+#include <chrono>
+#include <cstddef>
+
+/* 内存分配次数：由替换了全局 operator new 的基准程序负责累加，没有替换时始终为 0 */
+inline size_t alloc_count = 0;
+
+/* 每一项测量累计运行的最短时间（秒） */
+inline double min_time = 0.5;
+
+struct Stat
+{
+    double seconds;  // 单次运行的最短耗时
+    double allocs;   // 单次运行的平均内存分配次数
+};
+
+/* 先预热两次，然后反复运行直到累计耗时超过 min_time，取最快的一次 */
+template <typename F>
+inline Stat run(F f)
+{
+    f();
+    f();
+    Stat st{ 1e300, 0 };
+    double total = 0;
+    size_t before = alloc_count;
+    int iter = 0;
+    for (; total < min_time || iter < 3; ++iter) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        total += t;
+        if (t < st.seconds)
+            st.seconds = t;
+    }
+    st.allocs = double(alloc_count - before) / iter;
+    return st;
+}
+
+#endif
@@ -0,0 +1,67 @@
+/*
+    把某一课的 leptjson 包装为 BenchAdapter，构建脚本为每一课分别编译一次本文件：
+        LEPT_PREFIX    函数与类型名的前缀，见 lept_rename.h
+        LEPT_TUTORIAL  课程编号，决定哪些操作可用（07 起有 stringify，08 起有 copy 与 equal）
+        LEPT_NAME      在报告中显示的名字
+*/
+#include <cstdlib>
+#include "adapter.h"
+#include "lept_rename.h"
+
+extern "C" {
+#include "leptjson.h"
+}
+
+namespace
+{
+    void* create()
+    {
+        lept_value *v = static_cast<lept_value*>(malloc(sizeof(lept_value)));
+        lept_init(v);
+        return v;
+    }
+
+    void destroy(void *doc)
+    {
+        lept_free(static_cast<lept_value*>(doc));
+        free(doc);
+    }
+
+    bool parse(void *doc, const char *json, size_t)
+    {
+        lept_value *v = static_cast<lept_value*>(doc);
+        lept_free(v);
+        return lept_parse(v, json) == LEPT_PARSE_OK;
+    }
+
+#if LEPT_TUTORIAL >= 7
+    size_t stringify(const void *doc)
+    {
+        size_t length = 0;
+        free(lept_stringify(static_cast<const lept_value*>(doc), &length));
+        return length;
+    }
+#else
+    constexpr size_t (*stringify)(const void *) = nullptr;
+#endif
+
+#if LEPT_TUTORIAL >= 8
+    void copy(const void *doc)
+    {
+        lept_value v;
+        lept_init(&v);
+        lept_copy(&v, static_cast<const lept_value*>(doc));
+        lept_free(&v);
+    }
+
+    bool equal(const void *lhs, const void *rhs)
+    {
+        return lept_is_equal(static_cast<const lept_value*>(lhs), static_cast<const lept_value*>(rhs)) != 0;
+    }
+#else
+    constexpr void (*copy)(const void *) = nullptr;
+    constexpr bool (*equal)(const void *, const void *) = nullptr;
+#endif
+}
+
+extern const BenchAdapter LEPT_RENAME(bench_adapter) = { LEPT_NAME, create, destroy, parse, stringify, copy, equal };
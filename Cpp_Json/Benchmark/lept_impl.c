@@ -0,0 +1,3 @@
+/* 以带前缀的名字编译某一课的 leptjson.c（所在目录由构建脚本加入头文件搜索路径） */
+#include "lept_rename.h"
+#include "leptjson.c"
@@ -0,0 +1,57 @@
+#ifndef MINIJSON_BENCH_LEPT_RENAME_H__
+#define MINIJSON_BENCH_LEPT_RENAME_H__
+
+/*
+    C 教程的每一课都定义了同名的 lept_* 函数与类型，无法链接进同一个程序。
+    编译某一课时定义 LEPT_PREFIX（如 lept08_），把这些名字都加上前缀，例如 lept_parse 变为 lept08_parse。
+*/
+#define LEPT_CONCAT_(a, b) a##b
+#define LEPT_CONCAT(a, b) LEPT_CONCAT_(a, b)
+#define LEPT_RENAME(name) LEPT_CONCAT(LEPT_PREFIX, name)
+
+#define lept_type                   LEPT_RENAME(type)
+#define lept_value                  LEPT_RENAME(value)
+#define lept_member                 LEPT_RENAME(member)
+#define lept_context                LEPT_RENAME(context)
+
+#define lept_parse                  LEPT_RENAME(parse)
+#define lept_stringify              LEPT_RENAME(stringify)
+#define lept_copy                   LEPT_RENAME(copy)
+#define lept_move                   LEPT_RENAME(move)
+#define lept_swap                   LEPT_RENAME(swap)
+#define lept_free                   LEPT_RENAME(free)
+#define lept_get_type               LEPT_RENAME(get_type)
+#define lept_is_equal               LEPT_RENAME(is_equal)
+#define lept_get_boolean            LEPT_RENAME(get_boolean)
+#define lept_set_boolean            LEPT_RENAME(set_boolean)
+#define lept_get_number             LEPT_RENAME(get_number)
+#define lept_set_number             LEPT_RENAME(set_number)
+#define lept_get_string             LEPT_RENAME(get_string)
+#define lept_get_string_length      LEPT_RENAME(get_string_length)
+#define lept_set_string             LEPT_RENAME(set_string)
+#define lept_get_array_size         LEPT_RENAME(get_array_size)
+#define lept_get_array_element      LEPT_RENAME(get_array_element)
+#define lept_set_array              LEPT_RENAME(set_array)
+#define lept_get_array_capacity     LEPT_RENAME(get_array_capacity)
+#define lept_reserve_array          LEPT_RENAME(reserve_array)
+#define lept_shrink_array           LEPT_RENAME(shrink_array)
+#define lept_clear_array            LEPT_RENAME(clear_array)
+#define lept_pushback_array_element LEPT_RENAME(pushback_array_element)
+#define lept_popback_array_element  LEPT_RENAME(popback_array_element)
+#define lept_insert_array_element   LEPT_RENAME(insert_array_element)
+#define lept_erase_array_element    LEPT_RENAME(erase_array_element)
+#define lept_get_object_size        LEPT_RENAME(get_object_size)
+#define lept_get_object_key         LEPT_RENAME(get_object_key)
+#define lept_get_object_key_length  LEPT_RENAME(get_object_key_length)
+#define lept_get_object_value       LEPT_RENAME(get_object_value)
+#define lept_set_object             LEPT_RENAME(set_object)
+#define lept_get_object_capacity    LEPT_RENAME(get_object_capacity)
+#define lept_reserve_object         LEPT_RENAME(reserve_object)
+#define lept_shrink_object          LEPT_RENAME(shrink_object)
+#define lept_clear_object           LEPT_RENAME(clear_object)
+#define lept_find_object_index      LEPT_RENAME(find_object_index)
+#define lept_find_object_value      LEPT_RENAME(find_object_value)
+#define lept_set_object_value       LEPT_RENAME(set_object_value)
+#define lept_remove_object_value    LEPT_RENAME(remove_object_value)
+
+#endif
@@ -0,0 +1,54 @@
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "../Source/include/json.h"
+
+using namespace yfn;
+
+template <typename F>
+static double measure_ms(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+/* ID -> 记录的大对象：逐个插入 n 个 key，然后按 key 查找每一个成员 */
+static void bench_large_object(size_t n)
+{
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < n; ++i)
+        keys.push_back("id-" + std::to_string(i * 7919 % 1000003));
+
+    Json obj, record;
+    record.set_number(1);
+    double build = measure_ms([&] {
+        obj.set_object();
+        for (const std::string &key : keys)
+            obj.set_object_value(key, record);
+    });
+
+    long long sum = 0;
+    double lookup = measure_ms([&] {
+        for (const std::string &key : keys)
+            sum += obj.find_object_index(key);
+    });
+
+    std::string content;
+    obj.stringify(content);
+    Json parsed;
+    double parse = measure_ms([&] { parsed.parse(content); });
+
+    printf("object keys=%-8zu build=%.2f ms  lookup=%.1f ns/key  parse=%.2f ms  (checksum %lld)\n",
+           n, build, lookup * 1e6 / n, parse, sum);
+}
+
+int main()
+{
+    bench_large_object(1000);
+    bench_large_object(10000);
+    bench_large_object(50000);
+    return 0;
+}
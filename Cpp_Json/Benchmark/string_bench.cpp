@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include "../Source/include/json.h"
+
+using namespace yfn;
+
+/* 生成一个长度为 len 的 base64 字符串 */
+static std::string make_base64(size_t len, unsigned seed)
+{
+    static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string s;
+    s.reserve(len);
+    for (size_t i = 0; i < len; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        s += table[(seed >> 16) & 63];
+    }
+    return s;
+}
+
+/* 单个 16 MB 的 base64 字符串 */
+static std::string corpus_blob()
+{
+    return "\"" + make_base64(16 << 20, 1) + "\"";
+}
+
+/* 由日志记录组成的数组：每条记录的 message 字段都是较长的无转义文本，偶尔夹杂一个转义字符 */
+static std::string corpus_logs()
+{
+    std::string s = "[";
+    for (unsigned i = 0; i < 100000; ++i) {
+        if (i) s += ',';
+        s += "{\"level\":\"info\",\"logger\":\"com.example.service.RequestHandler\",\"message\":\"";
+        s += "request completed for user " + std::to_string(i) + " path=/api/v1/items/";
+        s += make_base64(64 + i % 128, i);
+        if (i % 8 == 0) s += "\\n\\tat handler";
+        s += "\"}";
+    }
+    s += "]";
+    return s;
+}
+
+/* 重复解析以及重新生成 content 多次，报告吞吐量 */
+static void bench(const char *name, const std::string &content, int iterations)
+{
+    double best_parse = 1e30, best_stringify = 1e30, best_exact = 1e30;
+    json::StringifyOptions exact;
+    exact.exact_size = true;
+    std::string out;
+    for (int i = 0; i < iterations; ++i) {
+        Json j;
+        auto start = std::chrono::steady_clock::now();
+        j.parse(content);
+        auto mid = std::chrono::steady_clock::now();
+        std::string grown;
+        j.stringify(grown);
+        auto end = std::chrono::steady_clock::now();
+        out.clear();
+        out.shrink_to_fit();
+        auto exact_start = std::chrono::steady_clock::now();
+        j.stringify(out, exact);
+        auto exact_end = std::chrono::steady_clock::now();
+        best_parse = std::min(best_parse, std::chrono::duration<double>(mid - start).count());
+        best_stringify = std::min(best_stringify, std::chrono::duration<double>(end - mid).count());
+        best_exact = std::min(best_exact, std::chrono::duration<double>(exact_end - exact_start).count());
+    }
+    printf("%-12s size=%-10zu parse     best=%8.3f ms  throughput=%6.3f GB/s\n",
+           name, content.size(), best_parse * 1e3, content.size() / best_parse / 1e9);
+    printf("%-12s size=%-10zu stringify best=%8.3f ms  throughput=%6.3f GB/s\n",
+           name, out.size(), best_stringify * 1e3, out.size() / best_stringify / 1e9);
+    printf("%-12s size=%-10zu exact     best=%8.3f ms  throughput=%6.3f GB/s\n",
+           name, out.size(), best_exact * 1e3, out.size() / best_exact / 1e9);
+}
+
+int main()
+{
+    bench("blob", corpus_blob(), 10);
+    bench("logs", corpus_logs(), 10);
+    return 0;
+}
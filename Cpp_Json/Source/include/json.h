@@ -1,8 +1,12 @@
 #ifndef JSON_H__
 #define JSON_H__
 
+#include <cstddef>
+#include <iterator>
 #include <memory>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 
 namespace yfn
 {
@@ -11,20 +15,228 @@ namespace yfn
         /* 枚举数据类型 */
         enum type : int{Null, True, False, Number, String, Array, Object};
 
+        /* 解析结果的错误码 */
+        enum error : int{
+            ParseOk, ParseExpectValue, ParseInvalidValue, ParseRootNotSingular, ParseNumberTooBig,
+            ParseMissQuotationMark, ParseInvalidStringEscape, ParseInvalidStringChar,
+            ParseInvalidUnicodeHex, ParseInvalidUnicodeSurrogate, ParseMissCommaOrSquareBracket,
+            ParseMissKey, ParseMissColon, ParseMissCommaOrCurlyBracket, ParseDepthExceeded, ParseCancelled, ParseFileError,
+            ParseInvalidUtf8
+        };
+
+        /* 解析结果：错误码以及出错位置相对于输入开头的字节偏移（解析成功时为输入的长度） */
+        struct ParseResult
+        {
+            error code;
+            size_t offset;
+            explicit operator bool() const noexcept { return code == ParseOk; }
+        };
+
+        /* 错误码对应的描述信息，返回静态字符串，不分配内存 */
+        const char* error_message(error code) noexcept;
+
+        /* 一次解析的统计信息 */
+        struct ParseStats
+        {
+            size_t nodes[Object + 1] = {};  // 按 json::type 统计的节点个数
+            size_t max_depth = 0;           // 数组与对象嵌套的最大层数，根节点为标量时为 0
+            size_t string_bytes = 0;        // 字符串值解码之后的总字节数
+            size_t key_bytes = 0;           // 对象 key 解码之后的总字节数
+            size_t allocations = 0;         // 解析过程中向内存资源（堆或 Document 的内存池）申请内存的次数
+            size_t allocated_bytes = 0;     // 上述申请的总字节数
+
+            size_t node_count() const noexcept
+            {
+                size_t n = 0;
+                for (size_t c : nodes) n += c;
+                return n;
+            }
+        };
+
+        /*
+            解析引擎：Scalar 逐个字符地解析；Structural 先用 SIMD 找出所有结构字符的位置，再沿着这个索引解析，适合大的输入。
+            两者构建出的树、产生的事件、错误码与出错位置都完全相同。Default 由编译选项 JSON_STRUCTURAL_ENGINE 决定，未开启时为 Scalar。
+        */
+        enum class ParseEngine : int { Default, Scalar, Structural };
+
+        /* 解析选项 */
+        struct ParseOptions
+        {
+            /* 数组与对象允许嵌套的最大层数，超过时解析失败，避免恶意输入耗尽内存或使后续的递归操作栈溢出 */
+            size_t max_depth = 1024;
+            /* 不为空时，解析结束后填写统计信息；为空时解析不做任何额外的工作 */
+            ParseStats *stats = nullptr;
+            /* 使用的解析引擎 */
+            ParseEngine engine = ParseEngine::Default;
+            /*
+                严格校验字符串中的 UTF-8：过长的编码、代理项、大于 U+10FFFF 的码点以及不完整的序列都解析失败，错误码为 ParseInvalidUtf8，
+                出错位置为不合法的序列的第一个字节。输入按窗口在解析到达之前用 SIMD 校验，窗口仍在缓存中，不需要再单独遍历一遍输入。
+            */
+            bool validate_utf8 = false;
+        };
+
+        /*
+            全局的内存分配钩子：Value、Parser 通过库的默认内存资源每申请（allocate 为 true）或释放一次内存，
+            以及 Generator 扩容输出字符串（报告新缓冲区的申请与旧缓冲区的释放，最后的缓冲区由调用者释放，不再报告），
+            都会以字节数调用一次钩子。可能在多个线程中同时被调用；传入 nullptr 取消。
+        */
+        using AllocationHook = void (*)(size_t bytes, bool allocate);
+        void set_allocation_hook(AllocationHook hook) noexcept;
+
+        /* 库的默认内存资源：Value 与解析器在没有指定内存资源时都从这里分配，并由它统计分配次数、调用分配钩子 */
+        std::pmr::memory_resource* default_resource() noexcept;
+
+        /*
+            SIMD 实现的级别："scalar"、"sse2"、"sse4.2"、"avx2"、"avx512"。第一次使用时检测一次 CPU 支持的指令集，选择可用的最快的级别，
+            环境变量 MINIJSON_SIMD 可以把级别限制在不超过指定的值（例如在较新的机器上测量较旧的机器上的性能）。
+            simd_level 返回当前的级别；set_simd_level 切换到指定的级别，没有编译进来或者 CPU 不支持时返回 false。
+            切换只应在没有其他线程正在解析或生成时进行。
+        */
+        const char* simd_level() noexcept;
+        bool set_simd_level(const char *name) noexcept;
+
+        /*
+            只校验 text 是否是合法的 UTF-8，不解析 json，规则与 ParseOptions::validate_utf8 相同。
+            合法时返回 ParseOk 与 text 的长度，否则返回 ParseInvalidUtf8 与第一个不合法的序列的字节偏移。
+        */
+        ParseResult validate_utf8(std::string_view text) noexcept;
+
         /* 前向声明 */
         class Value;
+        class Sink;         // 见 jsonSink.h
+        class PushParser;   // 见 jsonPushParser.h
+
+        /* 生成选项 */
+        struct StringifyOptions
+        {
+            /* 先遍历一遍整棵树算出输出的精确长度，字符串只扩容一次，之后的写入不会再触发扩容与拷贝 */
+            bool exact_size = false;
+        };
+
+        /* 生成到 Sink 时默认的缓冲区大小 */
+        constexpr size_t kDefaultSinkBufferSize = 64 * 1024;
+    } // namespace json
+
+    class JsonView;
+    class JsonRef;
+
+    namespace json
+    {
+        /* 对象中的一个键值对，key 与 value 都指向树中的数据 */
+        struct Member;
+
+        /*
+            数组的随机访问迭代器：直接遍历 Value 中保存元素的连续内存，每前进一步只是移动一次指针。
+            由于这里 Value 是不完整类型，迭代器按字节保存指针以及元素的大小（stride）。
+            解引用得到指向元素的 JsonView（代理对象），因此只适用于只读的算法。
+        */
+        class ArrayIterator final
+        {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = JsonView;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = JsonView;
+
+            ArrayIterator() noexcept = default;
+
+            JsonView operator*() const noexcept;
+            JsonView operator[](difference_type n) const noexcept;
+            ArrayIterator& operator++() noexcept { p_ += stride_; return *this; }
+            ArrayIterator operator++(int) noexcept { ArrayIterator tmp = *this; p_ += stride_; return tmp; }
+            ArrayIterator& operator--() noexcept { p_ -= stride_; return *this; }
+            ArrayIterator operator--(int) noexcept { ArrayIterator tmp = *this; p_ -= stride_; return tmp; }
+            ArrayIterator& operator+=(difference_type n) noexcept { p_ += n * static_cast<difference_type>(stride_); return *this; }
+            ArrayIterator& operator-=(difference_type n) noexcept { p_ -= n * static_cast<difference_type>(stride_); return *this; }
+            ArrayIterator operator+(difference_type n) const noexcept { ArrayIterator tmp = *this; return tmp += n; }
+            ArrayIterator operator-(difference_type n) const noexcept { ArrayIterator tmp = *this; return tmp -= n; }
+            friend ArrayIterator operator+(difference_type n, ArrayIterator it) noexcept { return it += n; }
+            difference_type operator-(const ArrayIterator &rhs) const noexcept { return stride_ ? (p_ - rhs.p_) / static_cast<difference_type>(stride_) : 0; }
+
+            bool operator==(const ArrayIterator &rhs) const noexcept { return p_ == rhs.p_; }
+            bool operator!=(const ArrayIterator &rhs) const noexcept { return p_ != rhs.p_; }
+            bool operator<(const ArrayIterator &rhs) const noexcept { return p_ < rhs.p_; }
+            bool operator>(const ArrayIterator &rhs) const noexcept { return p_ > rhs.p_; }
+            bool operator<=(const ArrayIterator &rhs) const noexcept { return p_ <= rhs.p_; }
+            bool operator>=(const ArrayIterator &rhs) const noexcept { return p_ >= rhs.p_; }
+        private:
+            ArrayIterator(const char *p, size_t stride) noexcept : p_(p), stride_(stride) { }
+            const char *p_ = nullptr;
+            size_t stride_ = 0;
+
+            friend class yfn::JsonView;
+        };
+
+        /* 对象的前向迭代器：按插入顺序遍历键值对 */
+        class ObjectIterator final
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Member;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = Member;
+
+            ObjectIterator() noexcept = default;
+
+            Member operator*() const noexcept;
+            ObjectIterator& operator++() noexcept { p_ += stride_; return *this; }
+            ObjectIterator operator++(int) noexcept { ObjectIterator tmp = *this; p_ += stride_; return tmp; }
+
+            bool operator==(const ObjectIterator &rhs) const noexcept { return p_ == rhs.p_; }
+            bool operator!=(const ObjectIterator &rhs) const noexcept { return p_ != rhs.p_; }
+        private:
+            ObjectIterator(const char *p, size_t stride) noexcept : p_(p), stride_(stride) { }
+            const char *p_ = nullptr;
+            size_t stride_ = 0;
+
+            friend class yfn::JsonView;
+        };
+
+        /* 对象的键值对区间，供 range-for 使用 */
+        struct ObjectRange
+        {
+            ObjectIterator first, last;
+            ObjectIterator begin() const noexcept { return first; }
+            ObjectIterator end() const noexcept { return last; }
+        };
     } // namespace json
     
     /* Json 类负责提供接口，Value 类负责实现接口，Json 类通过调用一个 std::unique_ptr 的智能指针实现对 Value 的访问 */
     class Json final
     {
     public:
-        /* 解析 json 字符串 */
-        void parse(const std::string &content, std::string &status) noexcept;
-        void parse(const std::string &content);
+        /* 解析 json 字符串：直接解析调用方的缓冲区，按长度做边界检查，不需要先拷贝到 std::string 中 */
+        void parse(std::string_view content, std::string &status, const json::ParseOptions &options = json::ParseOptions()) noexcept;
+        void parse(std::string_view content, const json::ParseOptions &options = json::ParseOptions());
+        void parse(const char *data, size_t len, const json::ParseOptions &options = json::ParseOptions());
+        /* 不抛出异常的解析接口：失败时返回错误码与字节偏移，并将 json 置为 null */
+        json::ParseResult try_parse(std::string_view content, const json::ParseOptions &options = json::ParseOptions()) noexcept;
+        json::ParseResult try_parse(const char *data, size_t len, const json::ParseOptions &options = json::ParseOptions()) noexcept;
+        /* 解析文件：只读映射整个文件并直接解析映射的内存，不需要先读入 std::string；文件无法打开或读取时错误码为 ParseFileError */
+        void parse_file(const std::string &path, const json::ParseOptions &options = json::ParseOptions());
+        json::ParseResult try_parse_file(const std::string &path, const json::ParseOptions &options = json::ParseOptions()) noexcept;
 
         /* 生成 json 字符串 */
-        void stringify(std::string &content) const noexcept;
+        void stringify(std::string &content, const json::StringifyOptions &options = json::StringifyOptions()) const noexcept;
+        /* 通过固定大小的缓冲区流式地生成到 sink，缓冲区写满就交给 sink；sink 写入失败时停止并返回 false */
+        bool stringify(json::Sink &sink, size_t buffer_size = json::kDefaultSinkBufferSize) const;
+
+        /* 生成的 json 文本的精确字节数，与 stringify 的输出一致，可用于在生成之前设置 Content-Length */
+        size_t serialized_size() const noexcept;
+
+        /* 整棵树占用的内存字节数，包括各个节点本身、字符串与容器的堆内存以及容器中尚未使用的容量 */
+        size_t memory_usage() const noexcept;
+
+        /* 不拷贝的只读视图与可修改的引用，指向 Json 内部的树，Json 被修改或销毁之后失效 */
+        JsonView view() const noexcept;
+        JsonRef ref() noexcept;
+
+        /* 遍历数组的元素（for (yfn::JsonView e : j)）以及对象的键值对（for (auto m : j.members())） */
+        json::ArrayIterator begin() const noexcept;
+        json::ArrayIterator end() const noexcept;
+        json::ObjectRange members() const noexcept;
 
         /* json 类的构造函数 */
         Json() noexcept;
@@ -48,7 +260,10 @@ namespace yfn
 
         /* 对字符串的操作 */
         const std::string get_string() const noexcept;
+        void set_string(const char *str) noexcept;
         void set_string(const std::string& str) noexcept;
+        void set_string(std::string&& str) noexcept;        // std::string 的缓冲区无法交给 pmr 字符串，仍然拷贝一次
+        void set_string(std::pmr::string&& str) noexcept;   // 从 json::default_resource() 分配的字符串直接接管其缓冲区，否则拷贝
         Json& operator=(const std::string& str) noexcept { set_string(str); return *this; }
 
         /* 对数组的操作 */
@@ -56,6 +271,7 @@ namespace yfn
         size_t get_array_size() const noexcept;
         Json get_array_element(size_t index) const noexcept;
         void pushback_array_element(const Json& val) noexcept;
+        void pushback_array_element(Json&& val) noexcept;
         void popback_array_element() noexcept;
         void insert_array_element(const Json &val, size_t index) noexcept;
         void erase_array_element(size_t index, size_t count) noexcept;
@@ -64,10 +280,11 @@ namespace yfn
         /* 对对象进行操作 */
         void set_object() noexcept;
         size_t get_object_size() const noexcept;
-        const std::string& get_object_key(size_t index) const noexcept;
+        std::string_view get_object_key(size_t index) const noexcept;
         size_t get_object_key_length(size_t index) const noexcept;
         Json get_object_value(size_t index) const noexcept;
         void set_object_value(const std::string &key, const Json &val) noexcept;
+        void set_object_value(const std::string &key, Json &&val) noexcept;
         long long find_object_index(const std::string &key) const noexcept;
         void remove_object_value(size_t index) noexcept;
         void clear_object() noexcept;
@@ -75,6 +292,12 @@ namespace yfn
         /* Json 类只提供接口，Value 负责实现该接口 */
         std::unique_ptr<json::Value> v;
 
+        /* Document::to_json() 等需要直接访问 v */
+        friend class Document;
+        friend class JsonView;
+        friend class JsonRef;
+        friend class json::PushParser;
+
         /* 友元函数 */
         friend bool operator==(const Json &lhs, const Json &rhs) noexcept;
         friend bool operator!=(const Json &lhs, const Json &rhs) noexcept;
@@ -83,5 +306,118 @@ namespace yfn
     bool operator==(const Json &lhs, const Json &rhs) noexcept;
     bool operator!=(const Json &lhs, const Json &rhs) noexcept;
     void swap(Json &lhs, Json &rhs) noexcept;
+
+    /*
+        JsonView 是指向树中某个节点的只读视图：只保存一个指针，访问子节点与字符串都不分配内存也不拷贝。
+        字符串以 std::string_view 的形式返回，生命周期与所指向的节点相同。
+    */
+    class JsonView final
+    {
+    public:
+        JsonView() noexcept = default; // 不指向任何节点，类型为 null
+
+        int get_type() const noexcept;
+        double get_number() const noexcept;
+        std::string_view get_string() const noexcept;
+
+        size_t get_array_size() const noexcept;
+        JsonView get_array_element(size_t index) const noexcept;
+
+        size_t get_object_size() const noexcept;
+        std::string_view get_object_key(size_t index) const noexcept;
+        size_t get_object_key_length(size_t index) const noexcept;
+        JsonView get_object_value(size_t index) const noexcept;
+        long long find_object_index(std::string_view key) const noexcept;
+
+        /* 遍历数组与对象，不指向任何节点时为空区间 */
+        json::ArrayIterator begin() const noexcept;
+        json::ArrayIterator end() const noexcept;
+        json::ObjectRange members() const noexcept;
+
+        void stringify(std::string &content, const json::StringifyOptions &options = json::StringifyOptions()) const noexcept;
+        bool stringify(json::Sink &sink, size_t buffer_size = json::kDefaultSinkBufferSize) const;
+        size_t serialized_size() const noexcept;
+        /* 所指向的子树占用的内存字节数，与 Json::memory_usage() 的计算方法相同 */
+        size_t memory_usage() const noexcept;
+        /* 深拷贝出一个独立的 Json */
+        Json to_json() const;
+    private:
+        explicit JsonView(const json::Value *v) noexcept : v(v) { }
+        const json::Value *v = nullptr;
+
+        friend class Json;
+        friend class JsonRef;
+        friend class Document;
+        friend class json::ArrayIterator;
+        friend class json::ObjectIterator;
+        friend bool operator==(JsonView lhs, JsonView rhs) noexcept;
+    };
+
+    namespace json
+    {
+        struct Member
+        {
+            std::string_view key;
+            JsonView value;
+        };
+
+        inline JsonView ArrayIterator::operator*() const noexcept
+        {
+            return JsonView(reinterpret_cast<const Value*>(p_));
+        }
+
+        inline JsonView ArrayIterator::operator[](difference_type n) const noexcept
+        {
+            return *(*this + n);
+        }
+    } // namespace json
+
+    bool operator==(JsonView lhs, JsonView rhs) noexcept;
+    bool operator!=(JsonView lhs, JsonView rhs) noexcept;
+
+    /* JsonRef 是指向树中某个节点的可修改引用，可以原地修改子节点而不必先拷贝出来再写回 */
+    class JsonRef final
+    {
+    public:
+        operator JsonView() const noexcept { return JsonView(v); }
+
+        int get_type() const noexcept;
+        double get_number() const noexcept;
+        std::string_view get_string() const noexcept;
+        size_t get_array_size() const noexcept;
+        JsonRef get_array_element(size_t index) const noexcept;
+        size_t get_object_size() const noexcept;
+        std::string_view get_object_key(size_t index) const noexcept;
+        JsonRef get_object_value(size_t index) const noexcept;
+        long long find_object_index(std::string_view key) const noexcept;
+
+        void set_null() const noexcept;
+        void set_boolean(bool b) const noexcept;
+        void set_number(double d) const noexcept;
+        void set_string(std::string_view str) const noexcept;
+
+        void set_array() const noexcept;
+        void pushback_array_element(const Json &val) const noexcept;
+        void pushback_array_element(Json &&val) const noexcept;
+        void popback_array_element() const noexcept;
+        void insert_array_element(const Json &val, size_t index) const noexcept;
+        void erase_array_element(size_t index, size_t count) const noexcept;
+        void clear_array() const noexcept;
+
+        void set_object() const noexcept;
+        void set_object_value(std::string_view key, const Json &val) const noexcept;
+        void set_object_value(std::string_view key, Json &&val) const noexcept;
+        void remove_object_value(size_t index) const noexcept;
+        void clear_object() const noexcept;
+
+        void stringify(std::string &content, const json::StringifyOptions &options = json::StringifyOptions()) const noexcept;
+        bool stringify(json::Sink &sink, size_t buffer_size = json::kDefaultSinkBufferSize) const;
+        size_t serialized_size() const noexcept;
+    private:
+        explicit JsonRef(json::Value *v) noexcept : v(v) { }
+        json::Value *v;
+
+        friend class Json;
+    };
 }
 #endif
\ No newline at end of file
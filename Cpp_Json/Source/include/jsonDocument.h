@@ -0,0 +1,97 @@
+#ifndef JSON_DOCUMENT_H__
+#define JSON_DOCUMENT_H__
+
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "json.h"
+#include "jsonValue.h"
+
+namespace yfn
+{
+    namespace json
+    {
+        /*
+            单调增长的内存池：分配只是移动指针，释放什么都不做。
+            每次分配都计入 ParseStats 的分配次数；分配钩子只在向系统申请或归还内存块时被调用。
+            reset() 不归还已经申请的内存块，只把分配位置移回开头，因此反复解析大小相近的文本时，预热之后不再调用 malloc。
+        */
+        class Arena final : public std::pmr::memory_resource
+        {
+        public:
+            explicit Arena(size_t block_size = 64 * 1024) noexcept;
+            ~Arena() noexcept override;
+            Arena(const Arena &) = delete;
+            Arena& operator=(const Arena &) = delete;
+
+            /* 丢弃所有已分配的对象，但保留内存块；若之前用到了多个内存块，则合并为一个足够大的内存块 */
+            void reset() noexcept;
+            /* 已经向系统申请的字节数 */
+            size_t capacity() const noexcept;
+            /* 当前已经分配出去的字节数 */
+            size_t used() const noexcept;
+        private:
+            void* do_allocate(size_t bytes, size_t alignment) override;
+            void do_deallocate(void *, size_t, size_t) noexcept override { }
+            bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+            /* 申请一个至少能放下 bytes 个字节的新内存块 */
+            void add_block(size_t bytes);
+            void release() noexcept;
+
+            struct Block
+            {
+                char *data;
+                size_t size;
+            };
+            std::vector<Block> blocks_;
+            size_t current_ = 0;     // 当前用于分配的内存块
+            char *ptr_ = nullptr;    // 当前内存块中下一次分配的位置
+            char *end_ = nullptr;
+            size_t block_size_;
+            size_t used_before_ = 0; // 当前内存块之前的内存块中已经分配出去的字节数
+        };
+    } // namespace json
+
+    /*
+        Document 持有一个内存池以及解析出来的根节点，所有的字符串、数组与对象都从内存池中分配。
+        重新解析或者 reset() 时不再逐个节点地析构整棵树，而是直接丢弃整个内存池，耗时与树的大小无关。
+        根节点只提供只读访问（root() 或 view()），需要修改或者在 Document 之外保存时，用 to_json() 拷贝出一个普通的 Json。
+    */
+    class Document final
+    {
+    public:
+        explicit Document(size_t block_size = 64 * 1024) noexcept;
+        ~Document() noexcept;
+        Document(const Document &) = delete;
+        Document& operator=(const Document &) = delete;
+
+        /* 解析 json 文本，之前解析出来的树随内存池一起丢弃；失败时根节点为 null */
+        json::ParseResult parse(std::string_view content, const json::ParseOptions &options = json::ParseOptions()) noexcept;
+        json::ParseResult parse(const char *data, size_t len, const json::ParseOptions &options = json::ParseOptions()) noexcept;
+        /* 解析文件：映射文件后直接解析，字符串都拷贝到内存池中，返回之后映射随即解除 */
+        json::ParseResult parse_file(const std::string &path, const json::ParseOptions &options = json::ParseOptions()) noexcept;
+
+        /* 丢弃解析出来的树，根节点重置为 null，内存块留给下一次解析 */
+        void reset() noexcept;
+
+        /* 访问根节点 */
+        const json::Value& root() const noexcept { return root_; }
+        JsonView view() const noexcept { return JsonView(&root_); }
+        /* 生成 json 字符串 */
+        void stringify(std::string &content, const json::StringifyOptions &options = json::StringifyOptions()) const noexcept;
+        bool stringify(json::Sink &sink, size_t buffer_size = json::kDefaultSinkBufferSize) const;
+        size_t serialized_size() const noexcept;
+        /* 把整棵树深拷贝为一个独立于内存池的 Json */
+        Json to_json() const;
+
+        /* 内存池已经向系统申请的字节数 */
+        size_t arena_capacity() const noexcept { return arena_.capacity(); }
+    private:
+        json::Arena arena_;
+        json::Value root_;
+    };
+} // namespace yfn
+
+#endif
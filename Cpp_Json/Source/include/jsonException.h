@@ -3,6 +3,7 @@
 
 #include <string>
 #include <stdexcept>
+#include "json.h"
 
 namespace yfn
 {
@@ -13,6 +14,14 @@ namespace yfn
         {
         public:
             Exception(const std::string& errMsg) : logic_error(errMsg) { }
+            Exception(error code, size_t offset) : logic_error(error_message(code)), code_(code), offset_(offset) { }
+
+            /* 解析失败时的错误码以及出错位置的字节偏移 */
+            error code() const noexcept { return code_; }
+            size_t offset() const noexcept { return offset_; }
+        private:
+            error code_ = ParseOk;
+            size_t offset_ = 0;
         };
     }
 }
@@ -1,24 +1,68 @@
 #ifndef JSON_GENERATOR_H__
 #define JSON_GENERATOR_H__
 
+#include <string.h>
+#include <memory>
 #include "jsonValue.h"
 
 namespace yfn
 {
     namespace json
     {
-        /* json 生成器 */
+        class Sink;
+
+        /*
+            json 生成器：所有输出都写入 [begin_, end_) 这一段缓冲区，cur_ 为下一个写入位置。
+            生成到 std::string 时缓冲区就是字符串本身，写满时扩容；生成到 Sink 时缓冲区大小固定，写满时整块交给 Sink。
+        */
         class Generator final
         {
         public:
             Generator(const Value& val, std::string& result);
+            /* 已知输出的精确长度：字符串只扩容一次，生成过程中不会再走扩容的分支 */
+            Generator(const Value& val, std::string& result, size_t exact_size);
+            Generator(const Value& val, Sink& sink, size_t buffer_size);
+            /* Sink 是否接受了全部输出 */
+            bool ok() const noexcept { return ok_; }
+
+            /* 计算生成的 json 文本的精确长度：字符串按需要转义的字节计算，数字按最短表示计算 */
+            static size_t serialized_size(const Value &v) noexcept;
         private:
             void stringify_value(const Value &v);
-            void stringify_string(const std::string &str);
+            void stringify_string(std::string_view str);
+
+            /* 写入字符，缓冲区不够时先腾出空间 */
+            void put(char ch)
+            {
+                if (cur_ == end_)
+                    make_room(1);
+                *cur_++ = ch;
+            }
+            void put(const char *data, size_t len)
+            {
+                if (size_t(end_ - cur_) < len) {
+                    put_slow(data, len);
+                    return;
+                }
+                memcpy(cur_, data, len);
+                cur_ += len;
+            }
+            void put_slow(const char *data, size_t len);
+            /* 保证缓冲区中至少有 len 个字节（生成到 Sink 时不超过缓冲区的大小）的空闲空间 */
+            void make_room(size_t len);
+            /* 把缓冲区中的内容交给 Sink */
+            void flush();
 
-            std::string &res_;
+            std::string *res_ = nullptr;
+            Sink *sink_ = nullptr;
+            std::unique_ptr<char[]> buffer_;
+            char *begin_ = nullptr;
+            char *cur_ = nullptr;
+            char *end_ = nullptr;
+            bool ok_ = true;
+            AllocationHook hook_;
         };
     }
 } // namespace yfn
 
-#endif
\ No newline at end of file
+#endif
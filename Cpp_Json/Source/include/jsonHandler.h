@@ -0,0 +1,39 @@
+#ifndef JSON_HANDLER_H__
+#define JSON_HANDLER_H__
+
+#include <string_view>
+#include "json.h"
+
+namespace yfn
+{
+    namespace json
+    {
+        /*
+            SAX 风格的事件处理器：解析器每识别出一个值就调用一次相应的函数，不构建任何树。
+            字符串与 key 没有转义字符时直接指向输入，否则指向解析器内部的缓冲区，都只在函数返回之前有效，需要保存时自行拷贝。
+            对象的每个成员依次产生 on_key 与值的事件；on_end_object/on_end_array 的参数为成员或元素的个数。
+            任何一个函数返回 false 都会停止解析，parse 返回 ParseCancelled 以及停止的位置。默认的实现什么也不做，只返回 true。
+        */
+        class Handler
+        {
+        public:
+            virtual ~Handler() = default;
+
+            virtual bool on_null() { return true; }
+            virtual bool on_bool(bool) { return true; }
+            virtual bool on_number(double) { return true; }
+            virtual bool on_string(std::string_view) { return true; }
+            virtual bool on_key(std::string_view) { return true; }
+            virtual bool on_start_object() { return true; }
+            virtual bool on_end_object(size_t) { return true; }
+            virtual bool on_start_array() { return true; }
+            virtual bool on_end_array(size_t) { return true; }
+        };
+
+        /* 以事件的形式解析 json 文本，语法检查与错误码都与 Json::try_parse 相同；options.stats 同样有效 */
+        ParseResult parse(std::string_view content, Handler &handler, const ParseOptions &options = ParseOptions());
+        ParseResult parse(const char *data, size_t len, Handler &handler, const ParseOptions &options = ParseOptions());
+    } // namespace json
+} // namespace yfn
+
+#endif
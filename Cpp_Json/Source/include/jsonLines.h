@@ -0,0 +1,58 @@
+#ifndef JSON_LINES_H__
+#define JSON_LINES_H__
+
+#include <functional>
+#include <string_view>
+#include <vector>
+#include "json.h"
+#include "jsonHandler.h"
+
+namespace yfn
+{
+    namespace json
+    {
+        /*
+            并行解析 JSON Lines（NDJSON）：每一行是一个独立的 json 文本，空行与只有空白的行被忽略。
+            输入先按换行切分为大约 batch_bytes 大小的批次，批次由多个工作线程并行解析，每个批次中的记录依次解析。
+        */
+        struct LinesOptions
+        {
+            /* 工作线程数，0 表示 std::thread::hardware_concurrency()；为 1 时在调用线程中解析，不创建线程 */
+            size_t threads = 0;
+            /* 每个批次的大约字节数，批次的边界总是落在换行符之后 */
+            size_t batch_bytes = 1 << 20;
+            /* 每条记录的解析选项；stats 在并行解析中无效 */
+            ParseOptions parse;
+        };
+
+        /* SAX 方式解析时使用的 Handler：每条记录的事件之前先调用 on_record */
+        class RecordHandler : public Handler
+        {
+        public:
+            /* offset 为记录在输入中的字节偏移；返回 false 时停止解析 */
+            virtual bool on_record(size_t) { return true; }
+        };
+
+        /* 按输入中的顺序在调用线程中逐条交出记录，index 为记录的序号（从 0 开始，不计空行）；返回 false 时停止 */
+        using RecordCallback = std::function<bool(size_t index, JsonView record)>;
+
+        /*
+            以 DOM 的形式解析：所有记录按顺序交给 on_record，JsonView 只在回调期间有效。
+            某条记录解析失败时，它之前的记录都已交出，返回该记录的错误码以及相对于整个输入的偏移；全部成功时偏移为输入的长度。
+            on_record 返回 false 时返回 ParseCancelled，偏移为该记录的开头，与 SAX 形式相同。
+            工作线程最多领先交出的位置 2 * threads 个批次，内存占用与输入的大小无关。
+        */
+        ParseResult parse_lines(std::string_view content, const RecordCallback &on_record, const LinesOptions &options = LinesOptions());
+        /* 把所有记录解析到 records 的末尾 */
+        ParseResult parse_lines(std::string_view content, std::vector<Json> &records, const LinesOptions &options = LinesOptions());
+        /*
+            以 SAX 的形式解析：工作线程把每个批次的事件缓存下来，调用线程按输入中的顺序把它们交给 handler，handler 只在调用线程中被调用。
+            事件与逐条调用 json::parse 得到的完全相同：某条记录解析失败时，交出它之前的所有记录以及它在出错之前的事件，之后的记录不会交出，
+            返回值与 DOM 形式相同；handler 返回 false 时返回 ParseCancelled，偏移为当时的记录的开头。
+            不含转义的字符串仍然直接指向输入，工作线程最多领先交出的位置 2 * threads 个批次。
+        */
+        ParseResult parse_lines(std::string_view content, RecordHandler &handler, const LinesOptions &options = LinesOptions());
+    } // namespace json
+} // namespace yfn
+
+#endif
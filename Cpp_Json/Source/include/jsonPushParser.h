@@ -0,0 +1,89 @@
+#ifndef JSON_PUSH_PARSER_H__
+#define JSON_PUSH_PARSER_H__
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "json.h"
+#include "jsonHandler.h"
+
+namespace yfn
+{
+    namespace json
+    {
+        /*
+            增量（push）解析器：json 文本可以分成任意大小的块，收到一块就 feed() 一块，最后调用 finish()。
+            每一块中完整的部分立即解析并产生事件，块与块之间只保存容器栈以及跨越块边界的那一个字符串、数字或字面值，
+            因此解析与接收可以交替进行，也不需要把整个文本拼接到一块连续的内存中。
+            语法检查、错误码与字节偏移（相对于整个文本的开头）都与一次性解析相同；出错之后的 feed() 与 finish() 都返回同一个错误。
+            options.stats 对增量解析无效。
+        */
+        class PushParser final
+        {
+        public:
+            /* 把事件交给 handler */
+            explicit PushParser(Handler &handler, const ParseOptions &options = ParseOptions());
+            /* 把解析结果构建到 target 中：target 先被置为 null，解析失败时也重置为 null */
+            explicit PushParser(Json &target, const ParseOptions &options = ParseOptions());
+            ~PushParser() noexcept;
+            PushParser(const PushParser &) = delete;
+            PushParser& operator=(const PushParser &) = delete;
+
+            /* 解析下一块文本，返回目前为止是否出错以及已经处理的字节数 */
+            ParseResult feed(const char *data, size_t len);
+            ParseResult feed(std::string_view chunk) { return feed(chunk.data(), chunk.size()); }
+            /* 输入结束：解析最后一个未完成的值并检查文本是否完整 */
+            ParseResult finish();
+            /* 丢弃所有状态，开始解析一个新的文本 */
+            void reset();
+        private:
+            /* 接下来期望的语法成分 */
+            enum class State : unsigned char
+            {
+                Value,              // 一个值
+                FirstValueOrClose,  // '[' 之后的第一个元素或 ']'
+                FirstKeyOrClose,    // '{' 之后的第一个 key 或 '}'
+                Key,                // ',' 之后的 key
+                Colon,              // key 之后的 ':'
+                AfterValue          // 值之后的 ',' 或右括号，栈为空时只允许空白
+            };
+            /* 正在读取的词法单元 */
+            enum class Token : unsigned char { None, String, Key, Number, Literal };
+            struct Frame
+            {
+                bool object;
+                size_t count;
+            };
+            class DomBuilder;
+
+            error process(const char *p, const char *end);
+            /* 从 p 开始寻找当前词法单元的结尾，返回结尾之后的位置；到达 end 仍未结束时返回 nullptr */
+            const char* scan_token(const char *p, const char *end) noexcept;
+            /* 解析一个完整的词法单元 [data, data + len)，base 为它在整个文本中的偏移 */
+            error handle_token(const char *data, size_t len, size_t base);
+            /* 一个值解析完成之后，栈顶容器中紧跟着出现非法字符时的错误码 */
+            error after_value_error() const noexcept;
+            error fail(error code, size_t offset) noexcept;
+            size_t at(const char *p) const noexcept { return base_ + static_cast<size_t>(p - chunk_); }
+
+            Handler *handler_;
+            std::unique_ptr<DomBuilder> dom_;
+            Json *target_ = nullptr;
+            ParseOptions options_;
+            std::vector<Frame> stack_;
+            State state_ = State::Value;
+            Token token_ = Token::None;
+            bool escape_ = false;       // 字符串中上一个字节是反斜杠
+            std::string carry_;         // 跨越块边界的词法单元已经收到的部分
+            size_t token_offset_ = 0;   // carry_ 在整个文本中的偏移
+            const char *chunk_ = nullptr;
+            size_t base_ = 0;           // 当前块在整个文本中的偏移
+            error error_ = ParseOk;
+            size_t error_offset_ = 0;
+            bool finished_ = false;
+        };
+    } // namespace json
+} // namespace yfn
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef JSON_SINK_H__
+#define JSON_SINK_H__
+
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <ostream>
+
+namespace yfn
+{
+    namespace json
+    {
+        /*
+            生成器的输出目标：生成器先把 json 文本写入固定大小的缓冲区，缓冲区满了再整块交给 write()，
+            因此峰值内存与输出的长度无关，第一块数据在缓冲区第一次写满时就已经送出。
+            write() 返回 false 表示输出失败，生成器随即停止生成，stringify 返回 false。
+        */
+        class Sink
+        {
+        public:
+            virtual ~Sink() = default;
+            virtual bool write(const char *data, size_t len) = 0;
+        };
+
+        /* 写入文件描述符：处理部分写入与 EINTR，不关闭描述符 */
+        class FdSink final : public Sink
+        {
+        public:
+            explicit FdSink(int fd) noexcept : fd_(fd) { }
+            bool write(const char *data, size_t len) override;
+        private:
+            int fd_;
+        };
+
+        /* 写入 FILE*：不调用 fflush，也不关闭文件 */
+        class FileSink final : public Sink
+        {
+        public:
+            explicit FileSink(std::FILE *file) noexcept : file_(file) { }
+            bool write(const char *data, size_t len) override;
+        private:
+            std::FILE *file_;
+        };
+
+        /* 写入 std::ostream：流进入失败状态时停止 */
+        class OStreamSink final : public Sink
+        {
+        public:
+            explicit OStreamSink(std::ostream &os) noexcept : os_(os) { }
+            bool write(const char *data, size_t len) override;
+        private:
+            std::ostream &os_;
+        };
+
+        /* 把每一块数据交给回调函数，回调返回 false 时停止 */
+        class CallbackSink final : public Sink
+        {
+        public:
+            using Callback = std::function<bool(const char *data, size_t len)>;
+            explicit CallbackSink(Callback callback) noexcept : callback_(std::move(callback)) { }
+            bool write(const char *data, size_t len) override;
+        private:
+            Callback callback_;
+        };
+    } // namespace json
+} // namespace yfn
+
+#endif
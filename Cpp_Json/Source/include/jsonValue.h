@@ -1,7 +1,9 @@
 #ifndef JOSN_VALUE_H__
 #define JOSN_VALUE_H__
 
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <utility>
 #include "json.h"
@@ -14,9 +16,25 @@ namespace yfn
         class Value final
         {
         public:
+            /*
+                字符串与容器都使用 std::pmr 版本：默认从 json::default_resource() 分配，
+                由 Document 解析时则全部从其内存池中分配（见 jsonDocument.h）。
+            */
+            using string_type = std::pmr::string;
+            using array_type = std::pmr::vector<Value>;
+            using member_type = std::pair<string_type, Value>;
+            using object_type = std::pmr::vector<member_type>;
+
             /* 解析 json 字符串、序列化 json 字符串 */
-            void parse(const std::string &content);
-            void stringify(std::string &content) const noexcept;
+            void parse(const char *data, size_t len, const ParseOptions &options = ParseOptions());
+            ParseResult try_parse(const char *data, size_t len, const ParseOptions &options = ParseOptions()) noexcept;
+            ParseResult try_parse(const char *data, size_t len, const ParseOptions &options, std::pmr::memory_resource *resource) noexcept;
+            void stringify(std::string &content, const StringifyOptions &options = StringifyOptions()) const noexcept;
+            bool stringify(Sink &sink, size_t buffer_size) const;
+            /* 生成的 json 文本的精确字节数 */
+            size_t serialized_size() const noexcept;
+            /* 除 Value 本身之外，该值占用的堆内存字节数（包括容器中尚未使用的容量） */
+            size_t memory_usage() const noexcept;
 
             /* 对 null、false、true 操作 */
             int get_type() const noexcept;
@@ -27,14 +45,20 @@ namespace yfn
             void set_number(double d) noexcept;
 
             /* 对字符串操作 */
-            const std::string& get_string() const noexcept;
-            void set_string(const std::string &str) noexcept;
+            std::string_view get_string() const noexcept;
+            void set_string(std::string_view str) noexcept;
+            void set_string(string_type &&str) noexcept;
 
             /* 对数组操作 */
             size_t get_array_size() const noexcept;
             const Value& get_array_element(size_t index) const noexcept;
-            void set_array(const std::vector<Value> &arr) noexcept;
+            Value& get_array_element(size_t index) noexcept;
+            const Value* array_data() const noexcept;
+            void set_array(const array_type &arr) noexcept;
+            void set_array(array_type &&arr) noexcept;
             void pushback_array_element(const Value& val) noexcept;
+            void pushback_array_element(Value &&val) noexcept;
+            Value& emplace_array_element() noexcept;
             void popback_array_element() noexcept;
             void insert_array_element(const Value &val, size_t index) noexcept;
             void erase_array_element(size_t index, size_t count) noexcept;
@@ -42,12 +66,17 @@ namespace yfn
 
             /* 对对象操作 */
             size_t get_object_size() const noexcept;
-            const std::string& get_object_key(size_t index) const noexcept;
+            std::string_view get_object_key(size_t index) const noexcept;
             size_t get_object_key_length(size_t index) const noexcept;
             const Value& get_object_value(size_t index) const noexcept;
-            void set_object_value(const std::string &key, const Value &val) noexcept;
-            void set_object(const std::vector<std::pair<std::string, Value>> &obj) noexcept;
-            long long find_object_index(const std::string &key) const noexcept;
+            Value& get_object_value(size_t index) noexcept;
+            const member_type* object_data() const noexcept;
+            void set_object_value(std::string_view key, const Value &val) noexcept;
+            void set_object_value(std::string_view key, Value &&val) noexcept;
+            Value& emplace_object_value(string_type &&key) noexcept;
+            void set_object(const object_type &obj) noexcept;
+            void set_object(object_type &&obj) noexcept;
+            long long find_object_index(std::string_view key) const noexcept;
             void remove_object_value(size_t index) noexcept;
             void clear_object() noexcept;
 
@@ -55,12 +84,31 @@ namespace yfn
             Value() noexcept { num_ = 0; }
             Value(const Value &rhs) noexcept { init(rhs); }
             Value& operator=(const Value &rhs) noexcept;
+            Value(Value &&rhs) noexcept { init(std::move(rhs)); }
+            Value& operator=(Value &&rhs) noexcept;
             ~Value() noexcept;
         private:
             /* 初始化 Value 与释放 Value 的内存 */
             void init(const Value &rhs) noexcept;
+            void init(Value &&rhs) noexcept;
             void free() noexcept;
 
+            /* 成员个数超过该阈值的对象会建立 key 的哈希索引，较小的对象直接线性查找 */
+            static constexpr size_t kObjectIndexThreshold = 16;
+            struct ObjectIndex;
+            /* 对象：按插入顺序保存的键值对，以及成员较多时建立的哈希索引（与 members 从同一个内存资源中分配） */
+            struct Object
+            {
+                object_type members;
+                ObjectIndex *index = nullptr;
+            };
+            /* 维护哈希索引：每次修改对象的成员后调用，保证索引与 members 同步 */
+            void index_rebuild() noexcept;
+            void index_insert(size_t pos) noexcept;
+            void index_erase(size_t pos) noexcept;
+            void index_free() noexcept;
+            long long index_find(std::string_view key) const noexcept;
+
             json::type type_ = json::Null;
 
             /*
@@ -70,9 +118,9 @@ namespace yfn
             union 
             {
                 double num_;
-                std::string str_;
-                std::vector<Value> arr_;
-                std::vector<std::pair<std::string, Value>> obj_;
+                string_type str_;
+                array_type arr_;
+                Object obj_;
             };
             
             friend bool operator==(const Value& lhs, const Value& rhs) noexcept;
@@ -1,6 +1,9 @@
 #ifndef PARSE_H__
 #define PARSE_H__
 
+#include <memory_resource>
+#include <string_view>
+#include <vector>
 #include "json.h"
 #include "jsonValue.h"
 
@@ -8,38 +11,53 @@ namespace yfn
 {
     namespace json
     {
-        /* 对 json 字符串的解析过程 */
+        /*
+            构建 DOM 的解析过程：词法与语法分析由 Reader（见 jsonReader.h）完成，Parser 只是其中的一种 Handler，
+            把每个事件转换为对 Value 树的修改，子节点直接在父容器中的最终位置上构建。
+        */
         class Parser final
         {
         public:
-            Parser(Value &val, const std::string &content);
+            /* 解析 [data, data + len) 中的 json 文本，输入不需要以 '\0' 结尾；解析出的字符串与容器都从 resource 中分配 */
+            Parser(Value &val, const char *data, size_t len, const ParseOptions &options, std::pmr::memory_resource *resource);
+            /* 解析整个 json 文本，失败时返回错误码与出错位置，不抛出异常 */
+            ParseResult parse() noexcept;
+
+            /* Reader 的事件 */
+            bool on_null() noexcept { slot().set_type(json::Null); return true; }
+            bool on_bool(bool b) noexcept { slot().set_type(b ? json::True : json::False); return true; }
+            bool on_number(double d) noexcept { slot().set_number(d); return true; }
+            bool on_string(std::string_view s) noexcept;
+            bool on_key(std::string_view key) noexcept;
+            bool on_start_object() noexcept;
+            bool on_end_object(size_t) noexcept { stack_.pop_back(); return true; }
+            bool on_start_array() noexcept;
+            bool on_end_array(size_t) noexcept { stack_.pop_back(); return true; }
         private:
-            /* 处理空白 */
-            void parse_whitespace() noexcept;
-            /* 解析 json 值 */
-            void parse_value();
-            /* 合并 false、true、null 的解析函数 */
-            void parse_literal(const char *literal, json::type t);
-            /* 解析数字 */
-            void parse_number();
-            /* 将之前解析字符串的函数拆分为两部分，是为了在解析 json 对象的 key 值时，不使用 lept_value 存储键，因为这样会浪费其中的 type 这个无用字段 */
-            void parse_string();
-            /* 解析 字符串 */
-            void parse_string_raw(std::string &tmp);
-            /* 读4位16进制数字 */
-            void parse_hex4(const char* &p, unsigned &u);
-            /* 把码点编码成 utf-8 */
-            void parse_encode_utf8(std::string &s, unsigned u) const noexcept;
-            /* 解析数组 */
-            void parse_array();
-            /* 解析对象 */
-            void parse_object();
+            /* 下一个值应当存放的位置：根节点、对象中刚刚由 on_key 建立的键值对，或者数组末尾新建的元素 */
+            Value& slot() noexcept
+            {
+                if (member_ != nullptr) {
+                    Value *v = member_;
+                    member_ = nullptr;
+                    return *v;
+                }
+                if (stack_.empty())
+                    return val_;
+                return stack_.back()->emplace_array_element();
+            }
 
             Value &val_;
-            const char *cur_;
+            const char *data_;
+            size_t len_;
+            const ParseOptions &options_;
+            std::pmr::memory_resource *resource_;
+            /* 尚未闭合的数组与对象 */
+            std::pmr::vector<Value*> stack_;
+            Value *member_ = nullptr;
         };
     } // namespace json
     
 }
 
-#endif
\ No newline at end of file
+#endif
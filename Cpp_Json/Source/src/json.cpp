@@ -1,28 +1,83 @@
+#include <new>
 #include "json.h"
-#include "jsonValue.h"
 #include "jsonException.h"
+#include "jsonFile.h"
+#include "jsonValue.h"
 
 namespace yfn
 {
-    void Json::parse(const std::string& content, std::string& status)noexcept
+    namespace json
     {
-        try{
-            parse(content);
-            status = "parse ok";
-        }catch (const json::Exception& msg){
-            status = msg.what();
-        }catch(...){
-
+        /* 错误码对应的描述信息 */
+        const char* error_message(error code) noexcept
+        {
+            static const char* const messages[] = {
+                "parse ok", "parse expect value", "parse invalid value", "parse root not singular", "parse number too big",
+                "parse miss quotation mark", "parse invalid string escape", "parse invalid string char",
+                "parse invalid unicode hex", "parse invalid unicode surrogate", "parse miss comma or square bracket",
+                "parse miss key", "parse miss colon", "parse miss comma or curly bracket", "parse depth exceeded",
+                "parse cancelled", "parse file error", "parse invalid utf8"
+            };
+            return messages[code];
         }
+    } // namespace json
+
+    void Json::parse(std::string_view content, std::string& status, const json::ParseOptions &options)noexcept
+    {
+        status = json::error_message(try_parse(content, options).code);
+    }
+
+    void Json::parse(std::string_view content, const json::ParseOptions &options){
+        v-> parse(content.data(), content.size(), options);
+    }
+
+    void Json::parse(const char *data, size_t len, const json::ParseOptions &options){
+        v-> parse(data, len, options);
+    }
+
+    json::ParseResult Json::try_parse(std::string_view content, const json::ParseOptions &options) noexcept{
+        return v-> try_parse(content.data(), content.size(), options);
+    }
+
+    json::ParseResult Json::try_parse(const char *data, size_t len, const json::ParseOptions &options) noexcept{
+        return v-> try_parse(data, len, options);
+    }
+
+    void Json::parse_file(const std::string &path, const json::ParseOptions &options){
+        json::ParseResult result = try_parse_file(path, options);
+        if (!result)
+            throw(json::Exception(result.code, result.offset));
     }
 
-    void Json::parse(const std::string &content){
-        v-> parse(content);
+    json::ParseResult Json::try_parse_file(const std::string &path, const json::ParseOptions &options) noexcept{
+        try {
+            json::MappedFile file;
+            if (!file.open(path.c_str())) {
+                v-> set_type(json::Null);
+                return json::ParseResult{ json::ParseFileError, 0 };
+            }
+            return v-> try_parse(file.data(), file.size(), options);
+        } catch (const std::bad_alloc &) {
+            v-> set_type(json::Null);
+            return json::ParseResult{ json::ParseFileError, 0 };
+        }
     }
 
     /* 生成 json 字符串 */
-    void Json::stringify(std::string &content) const noexcept{
-        v-> stringify(content);
+    void Json::stringify(std::string &content, const json::StringifyOptions &options) const noexcept{
+        v-> stringify(content, options);
+    }
+
+    bool Json::stringify(json::Sink &sink, size_t buffer_size) const{
+        return v-> stringify(sink, buffer_size);
+    }
+
+    size_t Json::serialized_size() const noexcept{
+        return v-> serialized_size();
+    }
+
+    size_t Json::memory_usage() const noexcept{
+        return sizeof(json::Value) + v-> memory_usage();
     }
 
     /* json 类的构造函数 */
@@ -76,16 +131,29 @@ namespace yfn
 
     /* 对字符串的操作 */
     const std::string Json::get_string() const noexcept{
-        return v-> get_string();
+        return std::string(v-> get_string());
+    }
+    void Json::set_string(const char *str) noexcept{
+        v-> set_string(std::string_view(str));
     }
     void Json::set_string(const std::string& str) noexcept{
         v-> set_string(str);
     }
+    void Json::set_string(std::string&& str) noexcept{// Value 中的字符串使用 pmr 分配器，无法直接接管 std::string 的缓冲区
+        v-> set_string(str);
+    }
+    void Json::set_string(std::pmr::string&& str) noexcept{
+        // 来自其他内存资源的缓冲区不能交给 Value，否则 Value 会依赖该资源的生命周期
+        if (str.get_allocator().resource()->is_equal(*json::default_resource()))
+            v-> set_string(std::move(str));
+        else
+            v-> set_string(std::string_view(str));
+    }
     
 
     /* 对数组的操作 */
     void Json::set_array() noexcept{
-    v-> set_array(std::vector<json::Value> {});
+    v-> set_array(json::Value::array_type(json::default_resource()));
     }
 
     size_t Json::get_array_size() const noexcept{
@@ -102,6 +170,10 @@ namespace yfn
         v-> pushback_array_element(*val.v);
     }
 
+    void Json::pushback_array_element(Json&& val) noexcept{// 移入元素后 val 变为 null
+        v-> pushback_array_element(std::move(*val.v));
+    }
+
     void Json::popback_array_element() noexcept{
         v-> popback_array_element();
     }
@@ -120,12 +192,12 @@ namespace yfn
 
     /* 对对象进行操作 */
     void Json::set_object() noexcept{
-        v-> set_object(std::vector<std::pair<std::string, json::Value>> {});
+        v-> set_object(json::Value::object_type(json::default_resource()));
     }
     size_t Json::get_object_size() const noexcept{
         return v-> get_object_size();
     }
-    const std::string& Json::get_object_key(size_t index) const noexcept{
+    std::string_view Json::get_object_key(size_t index) const noexcept{
         return v-> get_object_key(index);
     }
     size_t Json::get_object_key_length(size_t index) const noexcept{
@@ -139,6 +211,9 @@ namespace yfn
     void Json::set_object_value(const std::string &key, const Json &val) noexcept{
         v-> set_object_value(key, *val.v);
     }
+    void Json::set_object_value(const std::string &key, Json &&val) noexcept{
+        v-> set_object_value(key, std::move(*val.v));
+    }
     long long Json::find_object_index(const std::string &key) const noexcept{
         return v-> find_object_index(key);
     }
@@ -159,4 +234,195 @@ namespace yfn
 		return *lhs.v != *rhs.v;
 	}
     /* 两个友元函数的实现 */
+
+    /* 视图与引用 */
+    JsonView Json::view() const noexcept{
+        return JsonView(v.get());
+    }
+    JsonRef Json::ref() noexcept{
+        return JsonRef(v.get());
+    }
+
+    /* 迭代器 */
+    json::ArrayIterator Json::begin() const noexcept{
+        return view().begin();
+    }
+    json::ArrayIterator Json::end() const noexcept{
+        return view().end();
+    }
+    json::ObjectRange Json::members() const noexcept{
+        return view().members();
+    }
+
+    json::ArrayIterator JsonView::begin() const noexcept{
+        if(v == nullptr)return json::ArrayIterator();
+        return json::ArrayIterator(reinterpret_cast<const char*>(v-> array_data()), sizeof(json::Value));
+    }
+    json::ArrayIterator JsonView::end() const noexcept{
+        if(v == nullptr)return json::ArrayIterator();
+        return json::ArrayIterator(reinterpret_cast<const char*>(v-> array_data() + v-> get_array_size()), sizeof(json::Value));
+    }
+    json::ObjectRange JsonView::members() const noexcept{
+        if(v == nullptr)return json::ObjectRange();
+        const json::Value::member_type *data = v-> object_data();
+        size_t stride = sizeof(json::Value::member_type);
+        return json::ObjectRange{ json::ObjectIterator(reinterpret_cast<const char*>(data), stride),
+                                  json::ObjectIterator(reinterpret_cast<const char*>(data + v-> get_object_size()), stride) };
+    }
+
+    /* 解引用对象迭代器：需要 Value 的完整定义才能取出 key，因此不能写在头文件中 */
+    json::Member json::ObjectIterator::operator*() const noexcept{
+        auto member = reinterpret_cast<const json::Value::member_type*>(p_);
+        return json::Member{ member-> first, JsonView(&member-> second) };
+    }
+
+    /* JsonView 的只读操作，直接转发给所指向的 Value */
+    int JsonView::get_type() const noexcept{
+        if(v == nullptr)return json::Null;
+        return v-> get_type();
+    }
+    double JsonView::get_number() const noexcept{
+        return v-> get_number();
+    }
+    std::string_view JsonView::get_string() const noexcept{
+        return v-> get_string();
+    }
+    size_t JsonView::get_array_size() const noexcept{
+        return v-> get_array_size();
+    }
+    JsonView JsonView::get_array_element(size_t index) const noexcept{
+        return JsonView(&v-> get_array_element(index));
+    }
+    size_t JsonView::get_object_size() const noexcept{
+        return v-> get_object_size();
+    }
+    std::string_view JsonView::get_object_key(size_t index) const noexcept{
+        return v-> get_object_key(index);
+    }
+    size_t JsonView::get_object_key_length(size_t index) const noexcept{
+        return v-> get_object_key_length(index);
+    }
+    JsonView JsonView::get_object_value(size_t index) const noexcept{
+        return JsonView(&v-> get_object_value(index));
+    }
+    long long JsonView::find_object_index(std::string_view key) const noexcept{
+        return v-> find_object_index(key);
+    }
+    void JsonView::stringify(std::string &content, const json::StringifyOptions &options) const noexcept{
+        if(v == nullptr)content = "null";
+        else v-> stringify(content, options);
+    }
+    bool JsonView::stringify(json::Sink &sink, size_t buffer_size) const{
+        if(v == nullptr)return json::Value().stringify(sink, buffer_size);
+        return v-> stringify(sink, buffer_size);
+    }
+    size_t JsonView::serialized_size() const noexcept{
+        return v == nullptr ? 4 : v-> serialized_size();
+    }
+    size_t JsonView::memory_usage() const noexcept{
+        return v == nullptr ? 0 : sizeof(json::Value) + v-> memory_usage();
+    }
+    Json JsonView::to_json() const{
+        Json ret;
+        if(v != nullptr)*ret.v = *v;
+        return ret;
+    }
+
+    bool operator==(JsonView lhs, JsonView rhs) noexcept
+    {
+        if(lhs.v == nullptr || rhs.v == nullptr)
+            return lhs.get_type() == json::Null && rhs.get_type() == json::Null;
+        return *lhs.v == *rhs.v;
+    }
+
+    bool operator!=(JsonView lhs, JsonView rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+    /* JsonRef 的操作：原地读取或修改所指向的 Value */
+    int JsonRef::get_type() const noexcept{
+        return v-> get_type();
+    }
+    double JsonRef::get_number() const noexcept{
+        return v-> get_number();
+    }
+    std::string_view JsonRef::get_string() const noexcept{
+        return v-> get_string();
+    }
+    size_t JsonRef::get_array_size() const noexcept{
+        return v-> get_array_size();
+    }
+    JsonRef JsonRef::get_array_element(size_t index) const noexcept{
+        return JsonRef(&v-> get_array_element(index));
+    }
+    size_t JsonRef::get_object_size() const noexcept{
+        return v-> get_object_size();
+    }
+    std::string_view JsonRef::get_object_key(size_t index) const noexcept{
+        return v-> get_object_key(index);
+    }
+    JsonRef JsonRef::get_object_value(size_t index) const noexcept{
+        return JsonRef(&v-> get_object_value(index));
+    }
+    long long JsonRef::find_object_index(std::string_view key) const noexcept{
+        return v-> find_object_index(key);
+    }
+    void JsonRef::set_null() const noexcept{
+        v-> set_type(json::Null);
+    }
+    void JsonRef::set_boolean(bool b) const noexcept{
+        v-> set_type(b ? json::True : json::False);
+    }
+    void JsonRef::set_number(double d) const noexcept{
+        v-> set_number(d);
+    }
+    void JsonRef::set_string(std::string_view str) const noexcept{
+        v-> set_string(str);
+    }
+    void JsonRef::set_array() const noexcept{
+        v-> set_array(json::Value::array_type(json::default_resource()));
+    }
+    void JsonRef::pushback_array_element(const Json &val) const noexcept{
+        v-> pushback_array_element(*val.v);
+    }
+    void JsonRef::pushback_array_element(Json &&val) const noexcept{
+        v-> pushback_array_element(std::move(*val.v));
+    }
+    void JsonRef::popback_array_element() const noexcept{
+        v-> popback_array_element();
+    }
+    void JsonRef::insert_array_element(const Json &val, size_t index) const noexcept{
+        v-> insert_array_element(*val.v, index);
+    }
+    void JsonRef::erase_array_element(size_t index, size_t count) const noexcept{
+        v-> erase_array_element(index, count);
+    }
+    void JsonRef::clear_array() const noexcept{
+        v-> clear_array();
+    }
+    void JsonRef::set_object() const noexcept{
+        v-> set_object(json::Value::object_type(json::default_resource()));
+    }
+    void JsonRef::set_object_value(std::string_view key, const Json &val) const noexcept{
+        v-> set_object_value(key, *val.v);
+    }
+    void JsonRef::set_object_value(std::string_view key, Json &&val) const noexcept{
+        v-> set_object_value(key, std::move(*val.v));
+    }
+    void JsonRef::remove_object_value(size_t index) const noexcept{
+        v-> remove_object_value(index);
+    }
+    void JsonRef::clear_object() const noexcept{
+        v-> clear_object();
+    }
+    void JsonRef::stringify(std::string &content, const json::StringifyOptions &options) const noexcept{
+        v-> stringify(content, options);
+    }
+    bool JsonRef::stringify(json::Sink &sink, size_t buffer_size) const{
+        return v-> stringify(sink, buffer_size);
+    }
+    size_t JsonRef::serialized_size() const noexcept{
+        return v-> serialized_size();
+    }
 } // namespace yfn
@@ -0,0 +1,56 @@
+#include <atomic>
+#include "jsonAlloc.h"
+#include "jsonValue.h"
+
+namespace yfn
+{
+    namespace json
+    {
+        thread_local AllocationCounter allocation_counter;
+
+        static std::atomic<AllocationHook> hook { nullptr };
+
+        void set_allocation_hook(AllocationHook h) noexcept
+        {
+            hook.store(h, std::memory_order_release);
+        }
+
+        AllocationHook allocation_hook() noexcept
+        {
+            return hook.load(std::memory_order_acquire);
+        }
+
+        /* 库的默认内存资源：从 new/delete 分配，同时统计分配次数并通知钩子 */
+        class CountingResource final : public std::pmr::memory_resource
+        {
+        private:
+            void* do_allocate(size_t bytes, size_t alignment) override
+            {
+                void *p = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+                ++allocation_counter.count;
+                allocation_counter.bytes += bytes;
+                if (AllocationHook h = allocation_hook())
+                    h(bytes, true);
+                return p;
+            }
+
+            void do_deallocate(void *p, size_t bytes, size_t alignment) override
+            {
+                std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+                if (AllocationHook h = allocation_hook())
+                    h(bytes, false);
+            }
+
+            bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+            {
+                return this == &other;
+            }
+        };
+
+        std::pmr::memory_resource* default_resource() noexcept
+        {
+            static CountingResource resource;
+            return &resource;
+        }
+    } // namespace json
+} // namespace yfn
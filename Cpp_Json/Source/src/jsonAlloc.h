@@ -0,0 +1,24 @@
+#ifndef JSON_ALLOC_H__
+#define JSON_ALLOC_H__
+
+#include <stddef.h>
+#include "json.h"
+
+namespace yfn
+{
+    namespace json
+    {
+        /* 当前线程通过库的内存资源（默认资源以及 Document 的内存池）申请内存的次数与字节数，解析时据此填写 ParseStats */
+        struct AllocationCounter
+        {
+            size_t count = 0;
+            size_t bytes = 0;
+        };
+        extern thread_local AllocationCounter allocation_counter;
+
+        /* 当前安装的分配钩子，没有安装时为 nullptr */
+        AllocationHook allocation_hook() noexcept;
+    } // namespace json
+} // namespace yfn
+
+#endif
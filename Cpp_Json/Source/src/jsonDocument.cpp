@@ -0,0 +1,167 @@
+#include <stdint.h>
+#include <new>
+#include "jsonDocument.h"
+#include "jsonAlloc.h"
+#include "jsonFile.h"
+
+namespace yfn
+{
+    namespace json
+    {
+        Arena::Arena(size_t block_size) noexcept : block_size_(block_size) { }
+
+        Arena::~Arena() noexcept
+        {
+            release();
+        }
+
+        /* 从当前内存块中按对齐要求切出 bytes 个字节，放不下时依次尝试后面的内存块，都放不下才向系统申请 */
+        void* Arena::do_allocate(size_t bytes, size_t alignment)
+        {
+            for (;;) {
+                if (ptr_ != nullptr) {
+                    uintptr_t p = (reinterpret_cast<uintptr_t>(ptr_) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+                    if (p + bytes <= reinterpret_cast<uintptr_t>(end_)) {
+                        ptr_ = reinterpret_cast<char*>(p + bytes);
+                        ++allocation_counter.count;
+                        allocation_counter.bytes += bytes;
+                        return reinterpret_cast<void*>(p);
+                    }
+                }
+                if (ptr_ != nullptr && current_ + 1 < blocks_.size()) {
+                    used_before_ += ptr_ - blocks_[current_].data;
+                    ++current_;
+                    ptr_ = blocks_[current_].data;
+                    end_ = ptr_ + blocks_[current_].size;
+                    continue;
+                }
+                add_block(bytes + alignment);
+            }
+        }
+
+        /* 申请新的内存块并作为当前内存块：大小按几何级数增长，保证内存块的个数是对数级的 */
+        void Arena::add_block(size_t bytes)
+        {
+            size_t size = blocks_.empty() ? block_size_ : blocks_.back().size * 2;
+            if (size < bytes)
+                size = bytes;
+            char *data = static_cast<char*>(::operator new(size));
+            if (AllocationHook h = allocation_hook())
+                h(size, true);
+            if (ptr_ != nullptr)
+                used_before_ += ptr_ - blocks_[current_].data;
+            blocks_.push_back(Block{ data, size });
+            current_ = blocks_.size() - 1;
+            ptr_ = data;
+            end_ = data + size;
+        }
+
+        /* 归还所有内存块 */
+        void Arena::release() noexcept
+        {
+            AllocationHook h = allocation_hook();
+            for (const Block &b : blocks_) {
+                ::operator delete(b.data);
+                if (h != nullptr)
+                    h(b.size, false);
+            }
+            blocks_.clear();
+            ptr_ = end_ = nullptr;
+        }
+
+        void Arena::reset() noexcept
+        {
+            if (blocks_.size() > 1) {
+                // 上一轮用到了多个内存块，合并成一个，之后同样大小的文本只需要一个内存块
+                size_t total = capacity();
+                release();
+                blocks_.push_back(Block{ static_cast<char*>(::operator new(total, std::nothrow)), total });
+                if (blocks_.back().data == nullptr)
+                    blocks_.clear();
+                else if (AllocationHook h = allocation_hook())
+                    h(total, true);
+            }
+            current_ = 0;
+            used_before_ = 0;
+            if (blocks_.empty())
+                ptr_ = end_ = nullptr;
+            else {
+                ptr_ = blocks_[0].data;
+                end_ = ptr_ + blocks_[0].size;
+            }
+        }
+
+        size_t Arena::capacity() const noexcept
+        {
+            size_t total = 0;
+            for (const Block &b : blocks_)
+                total += b.size;
+            return total;
+        }
+
+        size_t Arena::used() const noexcept
+        {
+            return blocks_.empty() ? 0 : used_before_ + (ptr_ - blocks_[current_].data);
+        }
+    } // namespace json
+
+    Document::Document(size_t block_size) noexcept : arena_(block_size) { }
+
+    /* 树中所有的内存都属于内存池，不需要逐个节点地析构：直接在根节点上重新构造一个 null，随后由 arena_ 归还全部内存 */
+    Document::~Document() noexcept
+    {
+        new(&root_) json::Value();
+    }
+
+    void Document::reset() noexcept
+    {
+        new(&root_) json::Value();
+        arena_.reset();
+    }
+
+    json::ParseResult Document::parse(std::string_view content, const json::ParseOptions &options) noexcept
+    {
+        return parse(content.data(), content.size(), options);
+    }
+
+    json::ParseResult Document::parse(const char *data, size_t len, const json::ParseOptions &options) noexcept
+    {
+        reset();
+        return root_.try_parse(data, len, options, &arena_);
+    }
+
+    json::ParseResult Document::parse_file(const std::string &path, const json::ParseOptions &options) noexcept
+    {
+        reset();
+        try {
+            json::MappedFile file;
+            if (!file.open(path.c_str()))
+                return json::ParseResult{ json::ParseFileError, 0 };
+            return root_.try_parse(file.data(), file.size(), options, &arena_);
+        } catch (const std::bad_alloc &) {
+            return json::ParseResult{ json::ParseFileError, 0 };
+        }
+    }
+
+    void Document::stringify(std::string &content, const json::StringifyOptions &options) const noexcept
+    {
+        root_.stringify(content, options);
+    }
+
+    bool Document::stringify(json::Sink &sink, size_t buffer_size) const
+    {
+        return root_.stringify(sink, buffer_size);
+    }
+
+    size_t Document::serialized_size() const noexcept
+    {
+        return root_.serialized_size();
+    }
+
+    Json Document::to_json() const
+    {
+        Json ret;
+        *ret.v = root_;
+        return ret;
+    }
+} // namespace yfn
@@ -0,0 +1,122 @@
+#include <assert.h>
+#include <charconv>
+#include <math.h>
+#include <string.h>
+#include "jsonNumber.h"
+
+/*
+    double 的最短往返格式化：数字串由 std::to_chars 生成（libstdc++ 中为 Ryu 算法，保证是能精确解析回原值的最短表示，
+    并且与 locale 无关），然后按照 %.17g 的版式输出。整数值（|d| < 2^53）走单独的快速路径，直接输出整数的各位数字。
+*/
+namespace yfn
+{
+    namespace json
+    {
+        namespace
+        {
+            /* 输出十进制指数：e+XX 或 e-XX，与 %g 一样至少两位 */
+            char* write_exponent(int K, char *buffer) noexcept
+            {
+                *buffer++ = 'e';
+                if (K < 0) {
+                    *buffer++ = '-';
+                    K = -K;
+                }
+                else
+                    *buffer++ = '+';
+                if (K >= 100) {
+                    *buffer++ = static_cast<char>('0' + K / 100);
+                    K %= 100;
+                }
+                *buffer++ = static_cast<char>('0' + K / 10);
+                *buffer++ = static_cast<char>('0' + K % 10);
+                return buffer;
+            }
+
+            /*
+                把数字串 buffer[0, length) * 10^k 排版为 %.17g 的形式：
+                十进制指数 X 满足 -4 <= X < 17 时使用定点表示，否则使用科学计数法。
+            */
+            char* prettify(char *buffer, int length, int k) noexcept
+            {
+                const int kk = length + k; // 10^(kk-1) <= v < 10^kk
+
+                if (0 <= k && kk <= 17) {
+                    // 整数：1234e7 -> 12340000000
+                    memset(buffer + length, '0', static_cast<size_t>(k));
+                    return buffer + kk;
+                }
+                else if (0 < kk && kk <= 17) {
+                    // 1234e-2 -> 12.34
+                    memmove(buffer + kk + 1, buffer + kk, static_cast<size_t>(length - kk));
+                    buffer[kk] = '.';
+                    return buffer + length + 1;
+                }
+                else if (-4 < kk && kk <= 0) {
+                    // 1234e-6 -> 0.001234
+                    const int offset = 2 - kk;
+                    memmove(buffer + offset, buffer, static_cast<size_t>(length));
+                    buffer[0] = '0';
+                    buffer[1] = '.';
+                    memset(buffer + 2, '0', static_cast<size_t>(offset - 2));
+                    return buffer + length + offset;
+                }
+                else if (length == 1) {
+                    // 1e30
+                    return write_exponent(kk - 1, buffer + 1);
+                }
+                else {
+                    // 1234e30 -> 1.234e+33
+                    memmove(buffer + 2, buffer + 1, static_cast<size_t>(length - 1));
+                    buffer[1] = '.';
+                    return write_exponent(kk - 1, buffer + length + 1);
+                }
+            }
+
+            /* 把不超过 2^53 的非负整数逐位写入 buffer */
+            char* write_integer(uint64_t u, char *buffer) noexcept
+            {
+                char tmp[20];
+                int n = 0;
+                do {
+                    tmp[n++] = static_cast<char>('0' + u % 10);
+                    u /= 10;
+                } while (u != 0);
+                while (n > 0)
+                    *buffer++ = tmp[--n];
+                return buffer;
+            }
+        } // namespace
+
+        char* double_to_chars(double d, char *buffer) noexcept
+        {
+            assert(isfinite(d));
+            if (signbit(d)) {
+                *buffer++ = '-';
+                d = -d;
+            }
+
+            // 快速路径：整数值直接输出各位数字（包括 0 和 -0）
+            if (d < 9007199254740992.0 && d == static_cast<double>(static_cast<uint64_t>(d)))
+                return write_integer(static_cast<uint64_t>(d), buffer);
+
+            // 生成科学计数法形式的最短表示 d[.ddd]e±x，取出其中的有效数字与指数
+            char sci[kMaxDoubleLength];
+            char *end = std::to_chars(sci, sci + sizeof(sci), d, std::chars_format::scientific).ptr;
+            int length = 0;
+            const char *p = sci;
+            for (; *p != 'e'; ++p) {
+                if (*p != '.')
+                    buffer[length++] = *p;
+            }
+            ++p;
+            bool negative_exp = (*p++ == '-');
+            int exp = 0;
+            for (; p != end; ++p)
+                exp = exp * 10 + (*p - '0');
+            if (negative_exp)
+                exp = -exp;
+            return prettify(buffer, length, exp - (length - 1));
+        }
+    } // namespace json
+} // namespace yfn
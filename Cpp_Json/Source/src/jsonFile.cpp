@@ -0,0 +1,77 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "jsonFile.h"
+
+namespace yfn
+{
+    namespace json
+    {
+        namespace
+        {
+            /* 达到这个大小时才提示使用大页，小文件的页表开销可以忽略 */
+            constexpr size_t kHugePageThreshold = 2 * 1024 * 1024;
+
+            /* 关闭描述符：映射建立之后就不再需要它 */
+            struct FdGuard
+            {
+                int fd;
+                ~FdGuard() { if (fd >= 0) ::close(fd); }
+            };
+        }
+
+        MappedFile::~MappedFile() noexcept
+        {
+            if (map_ != nullptr)
+                ::munmap(map_, size_);
+        }
+
+        bool MappedFile::open(const char *path)
+        {
+            FdGuard fd{ ::open(path, O_RDONLY | O_CLOEXEC) };
+            if (fd.fd < 0)
+                return false;
+            struct stat st;
+            if (::fstat(fd.fd, &st) != 0)
+                return false;
+            if (!S_ISREG(st.st_mode))
+                return read_all(fd.fd);
+            size_t size = static_cast<size_t>(st.st_size);
+            if (size == 0)
+                return true;        // 空文件无法映射，按空文本解析
+            void *p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd.fd, 0);
+            if (p == MAP_FAILED)
+                return read_all(fd.fd);
+            ::madvise(p, size, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+            if (size >= kHugePageThreshold)
+                ::madvise(p, size, MADV_HUGEPAGE);      // 只是提示，内核或文件系统不支持时忽略
+#endif
+            map_ = p;
+            data_ = static_cast<const char*>(p);
+            size_ = size;
+            return true;
+        }
+
+        bool MappedFile::read_all(int fd)
+        {
+            char chunk[64 * 1024];
+            for (;;) {
+                ssize_t n = ::read(fd, chunk, sizeof(chunk));
+                if (n < 0) {
+                    if (errno == EINTR)
+                        continue;
+                    return false;
+                }
+                if (n == 0)
+                    break;
+                buffer_.append(chunk, static_cast<size_t>(n));
+            }
+            data_ = buffer_.data();
+            size_ = buffer_.size();
+            return true;
+        }
+    } // namespace json
+} // namespace yfn
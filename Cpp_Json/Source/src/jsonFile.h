@@ -0,0 +1,40 @@
+#ifndef JSON_FILE_H__
+#define JSON_FILE_H__
+
+#include <cstddef>
+#include <string>
+
+namespace yfn
+{
+    namespace json
+    {
+        /*
+            只读地映射整个文件，供 parse_file 直接解析映射的内存，省去读入 std::string 的拷贝与分配。
+            映射之后提示内核顺序访问，文件足够大时再提示使用大页。
+            不能映射的文件（管道、字符设备等）退回到一次性读入内部的缓冲区。
+        */
+        class MappedFile
+        {
+        public:
+            MappedFile() noexcept = default;
+            ~MappedFile() noexcept;
+            MappedFile(const MappedFile &) = delete;
+            MappedFile& operator=(const MappedFile &) = delete;
+
+            /* 打开并映射文件，失败时返回 false */
+            bool open(const char *path);
+
+            const char* data() const noexcept { return data_; }
+            size_t size() const noexcept { return size_; }
+        private:
+            bool read_all(int fd);
+
+            const char *data_ = "";
+            size_t size_ = 0;
+            void *map_ = nullptr;
+            std::string buffer_;
+        };
+    } // namespace json
+} // namespace yfn
+
+#endif
@@ -1,82 +1,218 @@
 #include "jsonGenerator.h"
+#include "jsonNumber.h"
+#include "jsonAlloc.h"
+#include "jsonSink.h"
+#include "jsonSimd.h"
+#include <array>
 #include <cassert>
 namespace yfn
 {
     namespace json
     {
-        /* 生成器的构造函数 */
-        Generator::Generator(const Value& val, std::string& result) : res_(result){
-            res_.clear();
+        /* 生成到字符串：直接在字符串的存储上写，结束时截掉没有用到的部分 */
+        Generator::Generator(const Value& val, std::string& result) : res_(&result), hook_(allocation_hook()){
+            res_->clear();
             stringify_value(val);
+            res_->resize(cur_ - begin_);
+        }
+
+        /* 按精确长度一次性调整字符串的大小，之后的 put 都落在 [begin_, end_) 之内 */
+        Generator::Generator(const Value& val, std::string& result, size_t exact_size) : res_(&result), hook_(allocation_hook()){
+            res_->clear();
+            if (exact_size > 0)
+                make_room(exact_size);
+            char *const expected_end = begin_ + exact_size;
+            stringify_value(val);
+            assert(cur_ == expected_end);
+            (void)expected_end;
+            res_->resize(cur_ - begin_);
+        }
+
+        /* 生成到 Sink：只申请一次 buffer_size 大小的缓冲区 */
+        Generator::Generator(const Value& val, Sink& sink, size_t buffer_size)
+            : sink_(&sink), buffer_(new char[buffer_size < 64 ? 64 : buffer_size]), hook_(allocation_hook()){
+            begin_ = cur_ = buffer_.get();
+            end_ = begin_ + (buffer_size < 64 ? 64 : buffer_size);
+            stringify_value(val);
+            flush();
+        }
+
+        /* 缓冲区放不下时：字符串一次扩容到足够大，Sink 则先填满缓冲区再逐块交出 */
+        void Generator::put_slow(const char *data, size_t len){
+            while (size_t(end_ - cur_) < len) {
+                if (res_ != nullptr) {
+                    make_room(len);
+                    break;
+                }
+                size_t n = end_ - cur_;
+                memcpy(cur_, data, n);
+                cur_ += n;
+                data += n;
+                len -= n;
+                make_room(1);
+            }
+            memcpy(cur_, data, len);
+            cur_ += len;
+        }
+
+        /* 字符串按几何级数扩容；扩容时通知分配钩子，报告新缓冲区的申请与旧的堆缓冲区的释放 */
+        void Generator::make_room(size_t len){
+            if (res_ == nullptr) {
+                flush();
+                return;
+            }
+            static const size_t sso_capacity = std::string().capacity();
+            size_t used = cur_ - begin_;
+            size_t old_capacity = res_->capacity();
+            size_t size = res_->size() * 2;
+            if (size < used + len)
+                size = used + len;
+            if (size < 256)
+                size = 256;
+            res_->resize(size);
+            if (hook_ != nullptr && res_->capacity() != old_capacity) {
+                if (old_capacity > sso_capacity)
+                    hook_(old_capacity + 1, false);
+                hook_(res_->capacity() + 1, true);
+            }
+            begin_ = &(*res_)[0];
+            cur_ = begin_ + used;
+            end_ = begin_ + size;
+        }
+
+        /* Sink 失败之后丢弃后续的输出，stringify_value 也会尽快停止 */
+        void Generator::flush(){
+            if (ok_ && cur_ != begin_)
+                ok_ = sink_->write(begin_, cur_ - begin_);
+            cur_ = begin_;
         }
 
         /* 生成 json 值 */
         void Generator::stringify_value(const Value& v){
+            if (!ok_)
+                return;
             switch(v.get_type()) {
-                case json::Null: res_ += "null"; break;
-                case json::True: res_ += "true"; break;
-                case json::False: res_ += "false"; break;
+                case json::Null: put("null", 4); break;
+                case json::True: put("true", 4); break;
+                case json::False: put("false", 5); break;
                 case json::Number:{
-                        char buffer[32] = {0};
-                        sprintf(buffer, "%.17g", v.get_number());
-                        res_ += buffer;
+                        // 生成能精确往返的最短表示
+                        char buffer[kMaxDoubleLength];
+                        put(buffer, double_to_chars(v.get_number(), buffer) - buffer);
                     }
                     break;
                 case json::String: stringify_string(v.get_string());// 生成字符串
                     break;
                 // 生成数组：只要输出"[]"，中间对逐个子值递归调用 stringify_value()
                 case json::Array:
-                    res_ += '[';
+                    put('[');
                     for(size_t i = 0; i < v.get_array_size(); i++){
-                        if (i > 0) res_ += ',';
+                        if (i > 0) put(',');
                         stringify_value(v.get_array_element(i));
                     }
-                    res_ += ']';
+                    put(']');
                     break;
                 // 生成对象
                 case json::Object:
-                    res_ += '{';
+                    put('{');
                     for (int i = 0; i < v.get_object_size(); ++i) {
-                        if (i > 0) res_ += ',';
+                        if (i > 0) put(',');
                         // 对象需要多处理一个 key 和冒号
                         stringify_string(v.get_object_key(i));
-                        res_ += ':';
+                        put(':');
                         // 递归调用生成 json 值
                         stringify_value(v.get_object_value(i));
                     }
-                    res_ += '}';
+                    put('}');
                     break;
                 default: assert(0 && "invalid type");
             }
         }
 
-        /* 生成字符串 */
-        void Generator::stringify_string(const std::string &str){
-            res_ += '\"';
-            for(auto it = str.begin(); it != str.end(); it++){
-                unsigned char ch = *it;
-                switch (ch)
-                {
-                    /* 添加这些转义字符 */
-                    case '\"': res_ += "\\\""; break;
-                    case '\\': res_ += "\\\\"; break;
-                    case '\b': res_ += "\\b";  break;
-                    case '\f': res_ += "\\f";  break;
-                    case '\n': res_ += "\\n";  break;
-                    case '\r': res_ += "\\r";  break;
-                    case '\t': res_ += "\\t";  break;
-                    default:
-                        // 低于 0x20 的字符需要转义为 \u00xx 的形式
-                        if (ch < 0x20) {
-                            char buffer[7] = {0};
-                            sprintf(buffer, "\\u%04X", ch);
-                            res_ += buffer;
-                        }
-                        else
-                            res_ += *it;
+        /* 转义表：需要转义的字节对应反斜杠之后的字符，没有简写形式的控制字符为 'u'，不需要转义的字节为 0 */
+        static constexpr std::array<char, 256> make_escape_table() noexcept
+        {
+            std::array<char, 256> table {};
+            for (int ch = 0; ch < 0x20; ++ch)
+                table[ch] = 'u';
+            table['\b'] = 'b';
+            table['\f'] = 'f';
+            table['\n'] = 'n';
+            table['\r'] = 'r';
+            table['\t'] = 't';
+            table['\"'] = '\"';
+            table['\\'] = '\\';
+            return table;
+        }
+        static constexpr std::array<char, 256> kEscapeTable = make_escape_table();
+
+        /* 生成字符串：用 scan_string 一次跳过 16/32 个不需要转义的字节，整段拷贝之后再查表转义遇到的字节 */
+        void Generator::stringify_string(std::string_view str){
+            static const char hex_digits[] = "0123456789ABCDEF";
+            const char *p = str.data();
+            const char *end = p + str.size();
+            put('\"');
+            for (;;) {
+                const char *q = scan_string(p, end);
+                put(p, q - p);
+                if (q == end)
+                    break;
+                unsigned char ch = static_cast<unsigned char>(*q);
+                char escape = kEscapeTable[ch];
+                assert(escape != 0);
+                if (escape == 'u') {
+                    // 低于 0x20 且没有简写形式的字符转义为 \u00XX 的形式
+                    const char buffer[6] = { '\\', 'u', '0', '0', hex_digits[ch >> 4], hex_digits[ch & 15] };
+                    put(buffer, 6);
+                }
+                else {
+                    const char buffer[2] = { '\\', escape };
+                    put(buffer, 2);
                 }
+                p = q + 1;
+            }
+            put('\"');// 添加最后一个双引号
+        }
+        /* 与 stringify_value 的输出一一对应：每个需要转义的字节多出 1 个（\n 等简写）或 5 个（\u00XX）字节 */
+        size_t Generator::serialized_size(const Value &v) noexcept{
+            auto string_size = [](std::string_view str) {
+                const char *p = str.data();
+                const char *end = p + str.size();
+                size_t n = str.size() + 2;
+                while ((p = scan_string(p, end)) != end) {
+                    n += kEscapeTable[static_cast<unsigned char>(*p)] == 'u' ? 5 : 1;
+                    ++p;
+                }
+                return n;
+            };
+            switch (v.get_type()) {
+                case json::Null:
+                case json::True: return 4;
+                case json::False: return 5;
+                case json::Number: {
+                        char buffer[kMaxDoubleLength];
+                        return double_to_chars(v.get_number(), buffer) - buffer;
+                    }
+                case json::String: return string_size(v.get_string());
+                case json::Array: {
+                        size_t n = v.get_array_size();
+                        size_t size = n > 0 ? n + 1 : 2;     // 方括号与 n - 1 个逗号
+                        const Value *e = v.array_data();
+                        for (size_t i = 0; i < n; ++i)
+                            size += serialized_size(e[i]);
+                        return size;
+                    }
+                case json::Object: {
+                        size_t n = v.get_object_size();
+                        size_t size = n > 0 ? 2 * n + 1 : 2; // 花括号、n - 1 个逗号与 n 个冒号
+                        const Value::member_type *m = v.object_data();
+                        for (size_t i = 0; i < n; ++i)
+                            size += string_size(m[i].first) + serialized_size(m[i].second);
+                        return size;
+                    }
+                default: assert(0 && "invalid type");
             }
-            res_ += '\"';// 添加最后一个双引号
+            return 0;
         }
     } // namespace json
     
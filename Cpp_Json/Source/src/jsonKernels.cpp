@@ -0,0 +1,114 @@
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include "json.h"
+#include "jsonKernels.h"
+
+namespace yfn
+{
+    namespace json
+    {
+        namespace
+        {
+            /* 一个级别：对应的实现以及 CPU 是否支持它用到的指令集，按从慢到快的顺序排列 */
+            struct Level
+            {
+                const char *name;
+                const Kernels* (*get)() noexcept;
+                bool (*supported)() noexcept;
+            };
+
+            bool always() noexcept { return true; }
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+            bool cpu_sse42() noexcept
+            {
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("popcnt");
+            }
+            bool cpu_avx2() noexcept
+            {
+                return cpu_sse42() && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi");
+            }
+            bool cpu_avx512() noexcept
+            {
+                return cpu_avx2() && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+            }
+#else
+            bool cpu_sse42() noexcept { return false; }
+            bool cpu_avx2() noexcept { return false; }
+            bool cpu_avx512() noexcept { return false; }
+#endif
+
+            const Level levels[] = {
+                { "scalar", scalar_kernels, always },
+                { "sse2", sse2_kernels, always },
+                { "sse4.2", sse42_kernels, cpu_sse42 },
+                { "avx2", avx2_kernels, cpu_avx2 },
+                { "avx512", avx512_kernels, cpu_avx512 },
+            };
+
+            std::atomic<const Kernels*> active{ nullptr };
+
+            /* 编译进来并且 CPU 支持时返回这一组实现 */
+            const Kernels* usable(const Level &level) noexcept
+            {
+                const Kernels *k = level.get();
+                return k != nullptr && level.supported() ? k : nullptr;
+            }
+
+            /* 选择可用的最快的实现；环境变量 MINIJSON_SIMD 指定了级别时，不超过该级别 */
+            const Kernels* detect() noexcept
+            {
+                const char *limit = getenv("MINIJSON_SIMD");
+                const Kernels *best = nullptr;
+                for (const Level &level : levels) {
+                    if (const Kernels *k = usable(level))
+                        best = k;
+                    if (limit != nullptr && strcmp(limit, level.name) == 0)
+                        break;
+                }
+                return best;
+            }
+        }
+
+        const Kernels& kernels() noexcept
+        {
+            const Kernels *k = active.load(std::memory_order_acquire);
+            if (k == nullptr) {
+                const Kernels *expected = nullptr;
+                k = detect();
+                // 与 set_simd_level 同时发生时以先设置的为准
+                if (!active.compare_exchange_strong(expected, k, std::memory_order_acq_rel))
+                    k = expected;
+            }
+            return *k;
+        }
+
+        const char* simd_level() noexcept
+        {
+            return kernels().name;
+        }
+
+        bool set_simd_level(const char *name) noexcept
+        {
+            for (const Level &level : levels) {
+                if (strcmp(name, level.name) == 0) {
+                    const Kernels *k = usable(level);
+                    if (k == nullptr)
+                        return false;
+                    active.store(k, std::memory_order_release);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        ParseResult validate_utf8(std::string_view text) noexcept
+        {
+            const char *end = text.data() + text.size();
+            const char *bad = kernels().validate_utf8(text.data(), end);
+            return ParseResult{ bad == end ? ParseOk : ParseInvalidUtf8, static_cast<size_t>(bad - text.data()) };
+        }
+    } // namespace json
+} // namespace yfn
@@ -0,0 +1,53 @@
+#ifndef JSON_KERNELS_H__
+#define JSON_KERNELS_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace yfn
+{
+    namespace json
+    {
+        /* 建立结构索引（见 jsonStructural.h）时跨块保存的状态 */
+        struct IndexState
+        {
+            uint64_t prev_escaped = 0;      // 上一个块的最后一个字节是否是转义用的反斜杠
+            uint64_t prev_in_string = 0;    // 上一个块是否在字符串内部结束，全 1 或者全 0
+            uint64_t prev_scalar = 0;       // 上一个块的最后一个字节是否属于字面值或数字
+        };
+
+        /*
+            一组 SIMD 实现。scalar 不依赖任何指令集，其余的各自在一个按对应指令集编译的翻译单元中（jsonKernels_*.cpp），
+            运行时按 CPU 支持的指令集选择其中最快的一组（见 json::set_simd_level）。
+            这些翻译单元只包含 C 的头文件、本文件与 jsonKernelsImpl.h，不实例化任何公共的模板或内联函数，
+            否则链接器可能把用较新指令集编译的那一份用到所有地方。
+        */
+        struct Kernels
+        {
+            const char *name;
+            /* [p, end) 中第一个双引号、反斜杠或者小于 0x20 的字节，没有时返回 end；解析字符串与生成时的转义都用它 */
+            const char* (*scan_string)(const char *p, const char *end);
+            /* [p, end) 中第一个不是空白的字节，没有时返回 end */
+            const char* (*skip_whitespace)(const char *p, const char *end);
+            /*
+                为 [data + begin, data + end) 中的各个 64 字节块生成结构索引，begin 是 64 的倍数，len 是整个输入的长度，
+                最后不足 64 字节的块按空白补齐。返回写入 out 的项数，out 之后需要留出 4 项的余量。
+            */
+            size_t (*index_structurals)(const char *data, size_t begin, size_t end, size_t len, IndexState &state, uint32_t *out);
+            /* [p, end) 中第一个不合法或者不完整的 UTF-8 编码序列的第一个字节，全部合法时返回 end；p 必须是一个字符的开头 */
+            const char* (*validate_utf8)(const char *p, const char *end);
+        };
+
+        /* 当前使用的一组实现 */
+        const Kernels& kernels() noexcept;
+
+        /* 各个指令集的实现，没有编译进来（例如不是 x86 平台）时返回 nullptr；不检查 CPU 是否支持 */
+        const Kernels* scalar_kernels() noexcept;
+        const Kernels* sse2_kernels() noexcept;
+        const Kernels* sse42_kernels() noexcept;
+        const Kernels* avx2_kernels() noexcept;
+        const Kernels* avx512_kernels() noexcept;
+    } // namespace json
+} // namespace yfn
+
+#endif
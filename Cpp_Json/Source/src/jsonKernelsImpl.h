@@ -0,0 +1,564 @@
+/*
+    各个 jsonKernels_*.cpp 共用的实现：每个翻译单元按自己的编译选项包含一次，得到一组只在本翻译单元内可见的函数。
+    按编译时可用的指令集选择代码路径（AVX-512BW、AVX2、SSE2，依次处理 64/32/16 字节），都不可用时逐字节处理；
+    UTF-8 的校验需要按字节查表（PSHUFB），只有 SSSE3 以上的指令集才逐块处理，SSE2 只用来跳过 ASCII；
+    包含之前定义 JSON_KERNELS_SCALAR 则总是逐字节处理。只允许包含 C 的头文件，原因见 jsonKernels.h。
+*/
+#ifndef JSON_KERNELS_IMPL_H__
+#define JSON_KERNELS_IMPL_H__
+
+#include <string.h>
+#include "jsonKernels.h"
+
+#if !defined(JSON_KERNELS_SCALAR)
+#if defined(__AVX512BW__)
+#define JSON_KERNELS_512
+#endif
+#if defined(__AVX2__)
+#define JSON_KERNELS_256
+#endif
+#if defined(__SSE2__)
+#define JSON_KERNELS_128
+#endif
+#if defined(__SSSE3__)
+#define JSON_KERNELS_SHUFFLE
+#endif
+#if defined(__PCLMUL__)
+#define JSON_KERNELS_CLMUL
+#endif
+#endif
+
+#if defined(JSON_KERNELS_128)
+#include <immintrin.h>
+#endif
+
+namespace yfn
+{
+    namespace json
+    {
+        namespace
+        {
+            inline bool is_special_byte(unsigned char ch) noexcept
+            {
+                return ch == '\"' || ch == '\\' || ch < 0x20;
+            }
+
+            inline bool is_space_byte(char ch) noexcept
+            {
+                return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r';
+            }
+
+            const char* scan_string_impl(const char *p, const char *end)
+            {
+#if defined(JSON_KERNELS_512)
+                for (; end - p >= 64; p += 64) {
+                    __m512i s = _mm512_loadu_si512(p);
+                    uint64_t mask = _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8('\"')) |
+                                    _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8('\\')) |
+                                    _mm512_cmple_epu8_mask(s, _mm512_set1_epi8(0x1F));
+                    if (mask != 0)
+                        return p + __builtin_ctzll(mask);
+                }
+#endif
+#if defined(JSON_KERNELS_256)
+                for (; end - p >= 32; p += 32) {
+                    __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+                    const __m256i ctrl = _mm256_set1_epi8(0x1F);
+                    // max(s, 0x1F) == 0x1F 当且仅当 s <= 0x1F（无符号比较）
+                    __m256i m = _mm256_or_si256(
+                        _mm256_or_si256(_mm256_cmpeq_epi8(s, _mm256_set1_epi8('\"')), _mm256_cmpeq_epi8(s, _mm256_set1_epi8('\\'))),
+                        _mm256_cmpeq_epi8(_mm256_max_epu8(s, ctrl), ctrl));
+                    unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(m));
+                    if (mask != 0)
+                        return p + __builtin_ctz(mask);
+                }
+#endif
+#if defined(JSON_KERNELS_128)
+                for (; end - p >= 16; p += 16) {
+                    __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                    const __m128i ctrl = _mm_set1_epi8(0x1F);
+                    __m128i m = _mm_or_si128(
+                        _mm_or_si128(_mm_cmpeq_epi8(s, _mm_set1_epi8('\"')), _mm_cmpeq_epi8(s, _mm_set1_epi8('\\'))),
+                        _mm_cmpeq_epi8(_mm_max_epu8(s, ctrl), ctrl));
+                    unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(m));
+                    if (mask != 0)
+                        return p + __builtin_ctz(mask);
+                }
+#endif
+                for (; p != end; ++p) {
+                    if (is_special_byte(static_cast<unsigned char>(*p)))
+                        return p;
+                }
+                return end;
+            }
+
+            const char* skip_whitespace_impl(const char *p, const char *end)
+            {
+#if defined(JSON_KERNELS_512)
+                for (; end - p >= 64; p += 64) {
+                    __m512i s = _mm512_loadu_si512(p);
+                    uint64_t space = _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8(' ')) | _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8('\t')) |
+                                     _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8('\n')) | _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8('\r'));
+                    if (~space != 0)
+                        return p + __builtin_ctzll(~space);
+                }
+#endif
+#if defined(JSON_KERNELS_256)
+                for (; end - p >= 32; p += 32) {
+                    __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+                    __m256i m = _mm256_or_si256(
+                        _mm256_or_si256(_mm256_cmpeq_epi8(s, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(s, _mm256_set1_epi8('\t'))),
+                        _mm256_or_si256(_mm256_cmpeq_epi8(s, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(s, _mm256_set1_epi8('\r'))));
+                    unsigned other = ~static_cast<unsigned>(_mm256_movemask_epi8(m));
+                    if (other != 0)
+                        return p + __builtin_ctz(other);
+                }
+#endif
+#if defined(JSON_KERNELS_128)
+                for (; end - p >= 16; p += 16) {
+                    __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                    __m128i m = _mm_or_si128(
+                        _mm_or_si128(_mm_cmpeq_epi8(s, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(s, _mm_set1_epi8('\t'))),
+                        _mm_or_si128(_mm_cmpeq_epi8(s, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(s, _mm_set1_epi8('\r'))));
+                    unsigned other = ~static_cast<unsigned>(_mm_movemask_epi8(m)) & 0xFFFF;
+                    if (other != 0)
+                        return p + __builtin_ctz(other);
+                }
+#endif
+                while (p != end && is_space_byte(*p))
+                    ++p;
+                return p;
+            }
+
+            /* 一个 64 字节块的分类结果，第 i 位对应块中的第 i 个字节 */
+            struct BlockMasks
+            {
+                uint64_t quote;
+                uint64_t backslash;
+                uint64_t space;
+                uint64_t op;
+            };
+
+            inline BlockMasks classify(const char *block) noexcept
+            {
+                BlockMasks m;
+#if defined(JSON_KERNELS_512)
+                __m512i s = _mm512_loadu_si512(block);
+                // '{' '}' 与 '[' ']' 只相差 0x20 这一位
+                __m512i lower = _mm512_or_si512(s, _mm512_set1_epi8(0x20));
+                m.quote = _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8('\"'));
+                m.backslash = _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8('\\'));
+                m.space = _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8(' ')) | _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8('\t')) |
+                          _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8('\n')) | _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8('\r'));
+                m.op = _mm512_cmpeq_epi8_mask(lower, _mm512_set1_epi8('{')) | _mm512_cmpeq_epi8_mask(lower, _mm512_set1_epi8('}')) |
+                       _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8(',')) | _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8(':'));
+#elif defined(JSON_KERNELS_256)
+                m = BlockMasks{ 0, 0, 0, 0 };
+                for (int i = 0; i < 2; ++i) {
+                    __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32 * i));
+                    __m256i lower = _mm256_or_si256(s, _mm256_set1_epi8(0x20));
+                    uint64_t quote = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(s, _mm256_set1_epi8('\"'))));
+                    uint64_t backslash = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(s, _mm256_set1_epi8('\\'))));
+                    uint64_t space = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(
+                        _mm256_or_si256(_mm256_cmpeq_epi8(s, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(s, _mm256_set1_epi8('\t'))),
+                        _mm256_or_si256(_mm256_cmpeq_epi8(s, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(s, _mm256_set1_epi8('\r'))))));
+                    uint64_t op = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(
+                        _mm256_or_si256(_mm256_cmpeq_epi8(lower, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('}'))),
+                        _mm256_or_si256(_mm256_cmpeq_epi8(s, _mm256_set1_epi8(',')), _mm256_cmpeq_epi8(s, _mm256_set1_epi8(':'))))));
+                    m.quote |= quote << (32 * i);
+                    m.backslash |= backslash << (32 * i);
+                    m.space |= space << (32 * i);
+                    m.op |= op << (32 * i);
+                }
+#elif defined(JSON_KERNELS_128)
+                m = BlockMasks{ 0, 0, 0, 0 };
+                for (int i = 0; i < 4; ++i) {
+                    __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * i));
+                    __m128i lower = _mm_or_si128(s, _mm_set1_epi8(0x20));
+                    uint64_t quote = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(s, _mm_set1_epi8('\"'))));
+                    uint64_t backslash = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(s, _mm_set1_epi8('\\'))));
+                    uint64_t space = static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(
+                        _mm_or_si128(_mm_cmpeq_epi8(s, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(s, _mm_set1_epi8('\t'))),
+                        _mm_or_si128(_mm_cmpeq_epi8(s, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(s, _mm_set1_epi8('\r'))))));
+                    uint64_t op = static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(
+                        _mm_or_si128(_mm_cmpeq_epi8(lower, _mm_set1_epi8('{')), _mm_cmpeq_epi8(lower, _mm_set1_epi8('}'))),
+                        _mm_or_si128(_mm_cmpeq_epi8(s, _mm_set1_epi8(',')), _mm_cmpeq_epi8(s, _mm_set1_epi8(':'))))));
+                    m.quote |= quote << (16 * i);
+                    m.backslash |= backslash << (16 * i);
+                    m.space |= space << (16 * i);
+                    m.op |= op << (16 * i);
+                }
+#else
+                m = BlockMasks{ 0, 0, 0, 0 };
+                for (int i = 0; i < 64; ++i) {
+                    char ch = block[i];
+                    uint64_t bit = uint64_t(1) << i;
+                    if (ch == '\"') m.quote |= bit;
+                    else if (ch == '\\') m.backslash |= bit;
+                    else if (is_space_byte(ch)) m.space |= bit;
+                    else if (ch == '{' || ch == '}' || ch == '[' || ch == ']' || ch == ',' || ch == ':') m.op |= bit;
+                }
+#endif
+                return m;
+            }
+
+            /*
+                被转义的字节：连续的反斜杠从第一个开始两两配对，每一对中的第一个转义第二个，奇数个时最后一个转义其后的字节。
+                用减法让每一段连续的反斜杠产生借位，一次算出所有段的奇偶；prev_escaped 记录跨块的转义。
+            */
+            inline uint64_t find_escaped(uint64_t backslash, uint64_t &prev_escaped) noexcept
+            {
+                const uint64_t odd_bits = 0xAAAAAAAAAAAAAAAAULL;
+                if (backslash == 0) {
+                    uint64_t escaped = prev_escaped;
+                    prev_escaped = 0;
+                    return escaped;
+                }
+                // 被上一块转义的反斜杠不再转义其他字节
+                uint64_t potential_escape = backslash & ~prev_escaped;
+                uint64_t escape_and_terminal = ((potential_escape << 1 | odd_bits) - potential_escape) ^ odd_bits;
+                uint64_t escaped = escape_and_terminal ^ (backslash | prev_escaped);
+                uint64_t escape = escape_and_terminal & backslash;
+                prev_escaped = escape >> 63;
+                return escaped;
+            }
+
+            /* 前缀异或：第 i 位为第 0~i 位的异或，引号之间（含开头的引号）为 1 */
+            inline uint64_t prefix_xor(uint64_t x) noexcept
+            {
+#if defined(JSON_KERNELS_CLMUL)
+                __m128i r = _mm_clmulepi64_si128(_mm_set_epi64x(0, static_cast<long long>(x)), _mm_set1_epi8(-1), 0);
+                return static_cast<uint64_t>(_mm_cvtsi128_si64(r));
+#else
+                x ^= x << 1;
+                x ^= x << 2;
+                x ^= x << 4;
+                x ^= x << 8;
+                x ^= x << 16;
+                x ^= x << 32;
+                return x;
+#endif
+            }
+
+            size_t index_structurals_impl(const char *data, size_t begin, size_t end, size_t len, IndexState &state, uint32_t *out)
+            {
+                uint32_t *const first = out;
+                for (size_t block = begin; block < end; block += 64) {
+                    // 最后不足 64 字节的块复制出来并用空白补齐，不读取输入之后的字节
+                    char tail[64];
+                    const char *p = data + block;
+                    if (len - block < 64) {
+                        memset(tail, ' ', sizeof(tail));
+                        memcpy(tail, p, len - block);
+                        p = tail;
+                    }
+                    BlockMasks m = classify(p);
+                    uint64_t quote = m.quote & ~find_escaped(m.backslash, state.prev_escaped);
+                    uint64_t in_string = prefix_xor(quote) ^ state.prev_in_string;
+                    state.prev_in_string = static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+                    // 字符串区域包括两端的引号，其中的结构字符与空白都不算
+                    uint64_t string_region = in_string | quote;
+                    uint64_t scalar = ~(m.op | m.space | string_region);
+                    uint64_t scalar_start = scalar & ~(scalar << 1 | state.prev_scalar);
+                    state.prev_scalar = scalar >> 63;
+                    uint64_t structurals = (m.op & ~string_region) | (quote & in_string) | scalar_start;
+                    // 每次无条件写出 4 项，多写的项随后被覆盖
+                    uint32_t base = static_cast<uint32_t>(block);
+                    uint32_t *next = out + __builtin_popcountll(structurals);
+                    while (structurals != 0) {
+                        for (int i = 0; i < 4; ++i) {
+                            out[i] = base + static_cast<uint32_t>(structurals != 0 ? __builtin_ctzll(structurals) : 0);
+                            structurals &= structurals - 1;
+                        }
+                        out += 4;
+                    }
+                    out = next;
+                }
+                return static_cast<size_t>(out - first);
+            }
+
+            /* 跳过连续的 ASCII 字节，返回第一个最高位为 1 的字节，没有时返回 end */
+            inline const char* skip_ascii(const char *p, const char *end) noexcept
+            {
+                // 非 ASCII 的文本中多数字符之间没有 ASCII 字节
+                if (p != end && static_cast<unsigned char>(*p) >= 0x80)
+                    return p;
+#if defined(JSON_KERNELS_128)
+                for (; end - p >= 16; p += 16) {
+                    unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))));
+                    if (mask != 0)
+                        return p + __builtin_ctz(mask);
+                }
+#else
+                for (; end - p >= 8; p += 8) {
+                    uint64_t word;
+                    memcpy(&word, p, 8);
+                    if ((word & 0x8080808080808080ULL) != 0)
+                        break;
+                }
+#endif
+                while (p != end && static_cast<unsigned char>(*p) < 0x80)
+                    ++p;
+                return p;
+            }
+
+            /*
+                逐个字符地校验 UTF-8，按 Unicode 标准的表 3-7：拒绝过长的编码、代理项（U+D800~U+DFFF）以及大于 U+10FFFF 的码点。
+                p 必须是一个字符的开头；返回第一个不合法或者不完整的序列的第一个字节。
+            */
+            const char* validate_utf8_bytes(const char *p, const char *end)
+            {
+                for (;;) {
+                    p = skip_ascii(p, end);
+                    if (p == end)
+                        return end;
+                    unsigned char lead = static_cast<unsigned char>(*p);
+                    // 第二个字节的取值范围随第一个字节而不同，之后的字节都是 10xxxxxx
+                    unsigned char low = 0x80, high = 0xBF;
+                    ptrdiff_t n;
+                    if (lead >= 0xC2 && lead <= 0xDF)
+                        n = 2;
+                    else if (lead >= 0xE0 && lead <= 0xEF) {
+                        n = 3;
+                        if (lead == 0xE0) low = 0xA0;
+                        else if (lead == 0xED) high = 0x9F;
+                    }
+                    else if (lead >= 0xF0 && lead <= 0xF4) {
+                        n = 4;
+                        if (lead == 0xF0) low = 0x90;
+                        else if (lead == 0xF4) high = 0x8F;
+                    }
+                    else return p;
+                    if (end - p < n)
+                        return p;
+                    unsigned char second = static_cast<unsigned char>(p[1]);
+                    if (second < low || second > high)
+                        return p;
+                    for (ptrdiff_t i = 2; i < n; ++i) {
+                        if ((static_cast<unsigned char>(p[i]) & 0xC0) != 0x80)
+                            return p;
+                    }
+                    p += n;
+                }
+            }
+
+            /* 包含 p 之前的那个字节的字符的开头：最多向前跳过 3 个 10xxxxxx 的字节 */
+            inline const char* sequence_start(const char *begin, const char *p) noexcept
+            {
+                const char *q = p - 1;
+                for (int i = 0; i < 3 && q != begin && (static_cast<unsigned char>(*q) & 0xC0) == 0x80; ++i)
+                    --q;
+                return q;
+            }
+
+#if defined(JSON_KERNELS_SHUFFLE)
+            /*
+                查表法校验 UTF-8（Keiser 与 Lemire，"Validating UTF-8 In Less Than One Instruction Per Byte"）：
+                每个字节与它前面的一个字节的高、低 4 位以及它自己的高 4 位各查一次 16 项的表，三个结果相与之后不为 0 的位就是对应的错误；
+                第三、四个字节是否必须是 10xxxxxx 由前面第二、三个字节判断。下面是各个错误对应的位。
+            */
+            constexpr uint8_t kTooShort = 1 << 0;       // 多字节序列的开头之后不是 10xxxxxx
+            constexpr uint8_t kTooLong = 1 << 1;        // ASCII 之后出现 10xxxxxx
+            constexpr uint8_t kOverlong3 = 1 << 2;      // 1110 0000 100x xxxx
+            constexpr uint8_t kTooLarge = 1 << 3;       // 大于 U+10FFFF：1111 0100 1001 xxxx 以上
+            constexpr uint8_t kSurrogate = 1 << 4;      // 1110 1101 101x xxxx
+            constexpr uint8_t kOverlong2 = 1 << 5;      // 1100 000x
+            constexpr uint8_t kTooLarge1000 = 1 << 6;   // 1111 0101 以上后面跟 1000 xxxx
+            constexpr uint8_t kOverlong4 = 1 << 6;      // 1111 0000 1000 xxxx
+            constexpr uint8_t kTwoConts = 1 << 7;       // 两个连续的 10xxxxxx
+            constexpr uint8_t kCarry = kTooShort | kTooLong | kTwoConts;
+
+            /* 查表用的 16 项表在 64 字节中重复 4 次，各个宽度的向量直接加载其开头的部分，每个 128 位的通道中都是完整的一份 */
+            struct LaneTable
+            {
+                alignas(64) uint8_t bytes[64];
+            };
+
+            constexpr LaneTable repeat_lanes(const uint8_t (&t)[16]) noexcept
+            {
+                LaneTable r{};
+                for (int i = 0; i < 64; ++i)
+                    r.bytes[i] = t[i % 16];
+                return r;
+            }
+
+            /* 以前一个字节的高 4 位查表 */
+            constexpr LaneTable kByte1High = repeat_lanes({
+                kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong,
+                kTwoConts, kTwoConts, kTwoConts, kTwoConts,
+                kTooShort | kOverlong2,
+                kTooShort,
+                kTooShort | kOverlong3 | kSurrogate,
+                kTooShort | kTooLarge | kTooLarge1000 | kOverlong4
+            });
+            /* 以前一个字节的低 4 位查表 */
+            constexpr LaneTable kByte1Low = repeat_lanes({
+                kCarry | kOverlong3 | kOverlong2 | kOverlong4,
+                kCarry | kOverlong2,
+                kCarry,
+                kCarry,
+                kCarry | kTooLarge,
+                kCarry | kTooLarge | kTooLarge1000,
+                kCarry | kTooLarge | kTooLarge1000,
+                kCarry | kTooLarge | kTooLarge1000,
+                kCarry | kTooLarge | kTooLarge1000,
+                kCarry | kTooLarge | kTooLarge1000,
+                kCarry | kTooLarge | kTooLarge1000,
+                kCarry | kTooLarge | kTooLarge1000,
+                kCarry | kTooLarge | kTooLarge1000,
+                kCarry | kTooLarge | kTooLarge1000 | kSurrogate,
+                kCarry | kTooLarge | kTooLarge1000,
+                kCarry | kTooLarge | kTooLarge1000
+            });
+            /* 以当前字节的高 4 位查表 */
+            constexpr LaneTable kByte2High = repeat_lanes({
+                kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort,
+                kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 | kOverlong4,
+                kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge,
+                kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+                kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+                kTooShort, kTooShort, kTooShort, kTooShort
+            });
+            /* 块的最后 3 个字节分别不小于 0xF0、0xE0、0xC0 时，序列在块内不完整；取其末尾与块一样长的部分 */
+            alignas(64) constexpr uint8_t kIncompleteMax[64] = {
+                0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1
+            };
+
+            /* 各个宽度的向量操作 */
+#if defined(JSON_KERNELS_512)
+            struct Utf8Simd
+            {
+                using V = __m512i;
+                static constexpr ptrdiff_t size = 64;
+                static V load(const void *p) noexcept { return _mm512_loadu_si512(p); }
+                static V table(const LaneTable &t) noexcept { return _mm512_load_si512(t.bytes); }
+                static V set1(uint8_t x) noexcept { return _mm512_set1_epi8(static_cast<char>(x)); }
+                static V zero() noexcept { return _mm512_setzero_si512(); }
+                static V lookup(V t, V index) noexcept { return _mm512_shuffle_epi8(t, index); }
+                static V shr4(V v) noexcept { return _mm512_srli_epi16(v, 4); }
+                static V and_(V a, V b) noexcept { return _mm512_and_si512(a, b); }
+                static V or_(V a, V b) noexcept { return _mm512_or_si512(a, b); }
+                static V xor_(V a, V b) noexcept { return _mm512_xor_si512(a, b); }
+                static V subs(V a, V b) noexcept { return _mm512_subs_epu8(a, b); }
+                /* 每个字节之前第 N 个字节，跨块时取自上一块 */
+                template <int N> static V prev(V input, V last) noexcept
+                {
+                    // 上一块的最后一个通道与本块的前三个通道
+                    V shifted = _mm512_permutex2var_epi32(last, _mm512_set_epi32(27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12), input);
+                    return _mm512_alignr_epi8(input, shifted, 16 - N);
+                }
+                static bool is_ascii(V v) noexcept { return _mm512_movepi8_mask(v) == 0; }
+                static bool any(V v) noexcept { return _mm512_test_epi8_mask(v, v) != 0; }
+            };
+#elif defined(JSON_KERNELS_256)
+            struct Utf8Simd
+            {
+                using V = __m256i;
+                static constexpr ptrdiff_t size = 32;
+                static V load(const void *p) noexcept { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+                static V table(const LaneTable &t) noexcept { return _mm256_load_si256(reinterpret_cast<const __m256i*>(t.bytes)); }
+                static V set1(uint8_t x) noexcept { return _mm256_set1_epi8(static_cast<char>(x)); }
+                static V zero() noexcept { return _mm256_setzero_si256(); }
+                static V lookup(V t, V index) noexcept { return _mm256_shuffle_epi8(t, index); }
+                static V shr4(V v) noexcept { return _mm256_srli_epi16(v, 4); }
+                static V and_(V a, V b) noexcept { return _mm256_and_si256(a, b); }
+                static V or_(V a, V b) noexcept { return _mm256_or_si256(a, b); }
+                static V xor_(V a, V b) noexcept { return _mm256_xor_si256(a, b); }
+                static V subs(V a, V b) noexcept { return _mm256_subs_epu8(a, b); }
+                template <int N> static V prev(V input, V last) noexcept
+                {
+                    // 上一块的高通道与本块的低通道
+                    return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(last, input, 0x21), 16 - N);
+                }
+                static bool is_ascii(V v) noexcept { return _mm256_movemask_epi8(v) == 0; }
+                static bool any(V v) noexcept { return !_mm256_testz_si256(v, v); }
+            };
+#else
+            struct Utf8Simd
+            {
+                using V = __m128i;
+                static constexpr ptrdiff_t size = 16;
+                static V load(const void *p) noexcept { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+                static V table(const LaneTable &t) noexcept { return _mm_load_si128(reinterpret_cast<const __m128i*>(t.bytes)); }
+                static V set1(uint8_t x) noexcept { return _mm_set1_epi8(static_cast<char>(x)); }
+                static V zero() noexcept { return _mm_setzero_si128(); }
+                static V lookup(V t, V index) noexcept { return _mm_shuffle_epi8(t, index); }
+                static V shr4(V v) noexcept { return _mm_srli_epi16(v, 4); }
+                static V and_(V a, V b) noexcept { return _mm_and_si128(a, b); }
+                static V or_(V a, V b) noexcept { return _mm_or_si128(a, b); }
+                static V xor_(V a, V b) noexcept { return _mm_xor_si128(a, b); }
+                static V subs(V a, V b) noexcept { return _mm_subs_epu8(a, b); }
+                template <int N> static V prev(V input, V last) noexcept { return _mm_alignr_epi8(input, last, 16 - N); }
+                static bool is_ascii(V v) noexcept { return _mm_movemask_epi8(v) == 0; }
+                static bool any(V v) noexcept { return _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())) != 0xFFFF; }
+            };
+#endif
+
+            /*
+                逐块校验，只判断块中是否有错误：全是 ASCII 的块只需要检查上一块的末尾是否不完整。
+                最后不足一块的部分复制出来用 0 补齐，0 是 ASCII，结尾处不完整的序列同样会被发现，较短的字符串因此也不必逐字节处理。
+                发现错误时，从包含上一块最后一个字节的字符开始逐字节校验，得到第一个错误的准确位置。
+            */
+            const char* validate_utf8_impl(const char *begin, const char *end)
+            {
+                using S = Utf8Simd;
+                const S::V byte_1_high = S::table(kByte1High), byte_1_low = S::table(kByte1Low), byte_2_high = S::table(kByte2High);
+                const S::V nibble = S::set1(0x0F), incomplete_max = S::load(kIncompleteMax + 64 - S::size);
+                S::V prev_input = S::zero(), prev_incomplete = S::zero();
+                const char *p = begin;
+                while (p != end) {
+                    ptrdiff_t n = end - p < S::size ? end - p : S::size;
+                    S::V input;
+                    if (n == S::size)
+                        input = S::load(p);
+                    else {
+                        alignas(64) char tail[64] = {};
+                        memcpy(tail, p, static_cast<size_t>(n));
+                        input = S::load(tail);
+                    }
+                    if (S::is_ascii(input)) {
+                        if (S::any(prev_incomplete))
+                            break;
+                    }
+                    else {
+                        S::V prev1 = S::prev<1>(input, prev_input);
+                        S::V special = S::and_(S::and_(
+                            S::lookup(byte_1_high, S::and_(S::shr4(prev1), nibble)),
+                            S::lookup(byte_1_low, S::and_(prev1, nibble))),
+                            S::lookup(byte_2_high, S::and_(S::shr4(input), nibble)));
+                        // 前面第二个字节是 111xxxxx 或者第三个字节是 1111xxxx 时，这个字节必须是 10xxxxxx，此时 special 中恰好是 kTwoConts
+                        S::V must_be_continuation = S::and_(S::or_(
+                            S::subs(S::prev<2>(input, prev_input), S::set1(0xE0 - 0x80)),
+                            S::subs(S::prev<3>(input, prev_input), S::set1(0xF0 - 0x80))), S::set1(0x80));
+                        if (S::any(S::xor_(must_be_continuation, special)))
+                            break;
+                        prev_incomplete = S::subs(input, incomplete_max);
+                        prev_input = input;
+                    }
+                    p += n;
+                }
+                if (p == end && !S::any(prev_incomplete))
+                    return end;
+                if (p != begin)
+                    p = sequence_start(begin, p);
+                return validate_utf8_bytes(p, end);
+            }
+#else
+            const char* validate_utf8_impl(const char *begin, const char *end)
+            {
+                return validate_utf8_bytes(begin, end);
+            }
+#endif
+
+            constexpr Kernels make_kernels(const char *name) noexcept
+            {
+                return Kernels{ name, scan_string_impl, skip_whitespace_impl, index_structurals_impl, validate_utf8_impl };
+            }
+        }
+    } // namespace json
+} // namespace yfn
+
+#endif
@@ -0,0 +1,21 @@
+/* 按 AVX-512BW、AVX2、BMI 与 PCLMUL 指令集编译（见 Source/CMakeLists.txt），没有这些编译选项时不提供这一组实现 */
+#include "jsonKernels.h"
+#if defined(__AVX512BW__) && defined(__PCLMUL__) && defined(__BMI__)
+#include "jsonKernelsImpl.h"
+#endif
+
+namespace yfn
+{
+    namespace json
+    {
+        const Kernels* avx512_kernels() noexcept
+        {
+#if defined(__AVX512BW__) && defined(__PCLMUL__) && defined(__BMI__)
+            static constexpr Kernels kernels = make_kernels("avx512");
+            return &kernels;
+#else
+            return nullptr;
+#endif
+        }
+    } // namespace json
+} // namespace yfn
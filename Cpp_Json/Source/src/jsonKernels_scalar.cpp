@@ -0,0 +1,15 @@
+/* 不依赖任何指令集的实现：没有 SIMD 的平台上使用，也用于对比测试与基准测试 */
+#define JSON_KERNELS_SCALAR
+#include "jsonKernelsImpl.h"
+
+namespace yfn
+{
+    namespace json
+    {
+        const Kernels* scalar_kernels() noexcept
+        {
+            static constexpr Kernels kernels = make_kernels("scalar");
+            return &kernels;
+        }
+    } // namespace json
+} // namespace yfn
@@ -0,0 +1,21 @@
+/* 不需要任何编译选项的基础实现：x86-64 上总是可以使用 SSE2 */
+#include "jsonKernels.h"
+#if defined(__SSE2__)
+#include "jsonKernelsImpl.h"
+#endif
+
+namespace yfn
+{
+    namespace json
+    {
+        const Kernels* sse2_kernels() noexcept
+        {
+#if defined(__SSE2__)
+            static constexpr Kernels kernels = make_kernels("sse2");
+            return &kernels;
+#else
+            return nullptr;
+#endif
+        }
+    } // namespace json
+} // namespace yfn
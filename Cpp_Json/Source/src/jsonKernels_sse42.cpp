@@ -0,0 +1,21 @@
+/* 按 SSE4.2、PCLMUL 与 POPCNT 指令集编译（见 Source/CMakeLists.txt），没有这些编译选项时不提供这一组实现 */
+#include "jsonKernels.h"
+#if defined(__SSE4_2__) && defined(__PCLMUL__) && defined(__POPCNT__)
+#include "jsonKernelsImpl.h"
+#endif
+
+namespace yfn
+{
+    namespace json
+    {
+        const Kernels* sse42_kernels() noexcept
+        {
+#if defined(__SSE4_2__) && defined(__PCLMUL__) && defined(__POPCNT__)
+            static constexpr Kernels kernels = make_kernels("sse4.2");
+            return &kernels;
+#else
+            return nullptr;
+#endif
+        }
+    } // namespace json
+} // namespace yfn
@@ -0,0 +1,361 @@
+#include <string.h>
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include "jsonLines.h"
+
+namespace yfn
+{
+    namespace json
+    {
+        namespace
+        {
+            /* 一个批次：若干条完整的记录，结尾总是换行符之后或者输入的末尾 */
+            struct Batch
+            {
+                const char *begin;
+                const char *end;
+            };
+
+            /* 按换行切分批次：从每个批次的目标大小处向后找到第一个换行符，只有批次的边界需要扫描 */
+            std::vector<Batch> split(std::string_view content, size_t batch_bytes)
+            {
+                std::vector<Batch> batches;
+                const char *p = content.data();
+                const char *end = p + content.size();
+                batch_bytes = std::max<size_t>(batch_bytes, 1);
+                while (p < end) {
+                    const char *e = end;
+                    if (static_cast<size_t>(end - p) > batch_bytes) {
+                        const void *nl = memchr(p + batch_bytes, '\n', end - (p + batch_bytes));
+                        if (nl != nullptr)
+                            e = static_cast<const char*>(nl) + 1;
+                    }
+                    batches.push_back(Batch{ p, e });
+                    p = e;
+                }
+                return batches;
+            }
+
+            bool is_blank(const char *p, const char *end) noexcept
+            {
+                for (; p != end; ++p)
+                    if (*p != ' ' && *p != '\t' && *p != '\r' && *p != '\n')
+                        return false;
+                return true;
+            }
+
+            /* 依次解析批次中的每条非空记录，f 返回的偏移相对于记录的开头，这里换算成相对于整个输入的偏移 */
+            template <class F>
+            ParseResult for_each_record(const Batch &batch, const char *base, F &&f)
+            {
+                const char *p = batch.begin;
+                while (p < batch.end) {
+                    const void *nl = memchr(p, '\n', batch.end - p);
+                    const char *e = nl != nullptr ? static_cast<const char*>(nl) : batch.end;
+                    if (!is_blank(p, e)) {
+                        ParseResult r = f(p, static_cast<size_t>(e - p));
+                        if (r.code != ParseOk)
+                            return ParseResult{ r.code, static_cast<size_t>(p - base) + r.offset };
+                    }
+                    p = e + 1;
+                }
+                return ParseResult{ ParseOk, static_cast<size_t>(batch.end - base) };
+            }
+
+            size_t thread_count(const LinesOptions &options, size_t batches) noexcept
+            {
+                size_t threads = options.threads != 0 ? options.threads : std::thread::hardware_concurrency();
+                return std::max<size_t>(1, std::min(threads, batches));
+            }
+
+            /* 工作线程：析构时通知所有线程停止并等待它们结束，提前返回或者回调抛出异常时也不会留下仍在运行的线程 */
+            class Workers
+            {
+            public:
+                explicit Workers(std::function<void()> stop) : stop_(std::move(stop)) { }
+                ~Workers()
+                {
+                    if (!threads_.empty())
+                        stop_();
+                    join();
+                }
+                /* 等待所有线程自然结束 */
+                void join()
+                {
+                    for (std::thread &t : threads_)
+                        t.join();
+                    threads_.clear();
+                }
+                template <class F>
+                void start(size_t count, F f)
+                {
+                    for (size_t i = 0; i < count; ++i)
+                        threads_.emplace_back(f, i);
+                }
+            private:
+                std::function<void()> stop_;
+                std::vector<std::thread> threads_;
+            };
+
+            /* 一个批次的 DOM 解析结果：解析成功的记录、各自开头的偏移，以及批次中的第一个错误 */
+            struct RecordSlot
+            {
+                std::vector<Json> records;
+                std::vector<size_t> starts;
+                ParseResult result{ ParseOk, 0 };
+                std::exception_ptr error;   // 解析时抛出的异常，交出这个批次时在调用线程中重新抛出
+                bool ready = false;
+            };
+
+            /* 缓存下来的一个 SAX 事件 */
+            struct Event
+            {
+                enum Kind : unsigned char { Record, Null, Bool, Number, String, Key, StartObject, EndObject, StartArray, EndArray };
+                Kind kind;
+                bool flag;          // on_bool 的值；字符串是否保存在批次的 text 中
+                size_t size;        // 记录的偏移、容器的元素个数或者字符串的长度
+                union
+                {
+                    double number;
+                    const char *data;   // 直接指向输入的字符串
+                    size_t pos;         // 保存在 text 中的字符串的位置
+                };
+            };
+
+            /* 一个批次的 SAX 解析结果：所有事件，含转义的字符串解码之后保存在 text 中，以及批次中的第一个错误 */
+            struct EventSlot
+            {
+                std::vector<Event> events;
+                std::string text;
+                ParseResult result{ ParseOk, 0 };
+                std::exception_ptr error;   // 解析时抛出的异常，交出这个批次时在调用线程中重新抛出
+                bool ready = false;
+            };
+
+            /* 工作线程中把事件记录到 EventSlot 的 Handler；指向输入的字符串只记录位置，输入在整个解析过程中都有效 */
+            class EventBuffer final : public RecordHandler
+            {
+            public:
+                EventBuffer(EventSlot &slot, std::string_view content) noexcept : slot_(slot), content_(content) { }
+
+                bool on_record(size_t offset) override { return add(Event::Record, false, offset); }
+                bool on_null() override { return add(Event::Null, false, 0); }
+                bool on_bool(bool b) override { return add(Event::Bool, b, 0); }
+                bool on_number(double d) override
+                {
+                    add(Event::Number, false, 0);
+                    slot_.events.back().number = d;
+                    return true;
+                }
+                bool on_string(std::string_view s) override { return add_string(Event::String, s); }
+                bool on_key(std::string_view k) override { return add_string(Event::Key, k); }
+                bool on_start_object() override { return add(Event::StartObject, false, 0); }
+                bool on_end_object(size_t n) override { return add(Event::EndObject, false, n); }
+                bool on_start_array() override { return add(Event::StartArray, false, 0); }
+                bool on_end_array(size_t n) override { return add(Event::EndArray, false, n); }
+            private:
+                bool add(Event::Kind kind, bool flag, size_t size)
+                {
+                    Event e;
+                    e.kind = kind;
+                    e.flag = flag;
+                    e.size = size;
+                    e.pos = 0;
+                    slot_.events.push_back(e);
+                    return true;
+                }
+
+                bool add_string(Event::Kind kind, std::string_view s)
+                {
+                    bool in_input = s.data() >= content_.data() && s.data() + s.size() <= content_.data() + content_.size();
+                    add(kind, !in_input, s.size());
+                    if (in_input)
+                        slot_.events.back().data = s.data();
+                    else {
+                        slot_.events.back().pos = slot_.text.size();
+                        slot_.text.append(s);
+                    }
+                    return true;
+                }
+
+                EventSlot &slot_;
+                std::string_view content_;
+            };
+
+            /* 在调用线程中把一个批次的事件交给 handler；handler 返回 false 时返回 ParseCancelled 与当时的记录的开头 */
+            ParseResult replay(const EventSlot &slot, RecordHandler &handler)
+            {
+                size_t record = 0;
+                for (const Event &e : slot.events) {
+                    bool ok = true;
+                    switch (e.kind)
+                    {
+                    case Event::Record: record = e.size; ok = handler.on_record(e.size); break;
+                    case Event::Null: ok = handler.on_null(); break;
+                    case Event::Bool: ok = handler.on_bool(e.flag); break;
+                    case Event::Number: ok = handler.on_number(e.number); break;
+                    case Event::String:
+                    case Event::Key: {
+                            std::string_view s(e.flag ? slot.text.data() + e.pos : e.data, e.size);
+                            ok = e.kind == Event::String ? handler.on_string(s) : handler.on_key(s);
+                        }
+                        break;
+                    case Event::StartObject: ok = handler.on_start_object(); break;
+                    case Event::EndObject: ok = handler.on_end_object(e.size); break;
+                    case Event::StartArray: ok = handler.on_start_array(); break;
+                    case Event::EndArray: ok = handler.on_end_array(e.size); break;
+                    }
+                    if (!ok)
+                        return ParseResult{ ParseCancelled, record };
+                }
+                return slot.result;
+            }
+
+            /*
+                按顺序交出批次的结果：工作线程调用 parse_batch 并行解析批次，调用线程按批次的顺序等待并调用 deliver 交出其中的结果。
+                工作线程最多领先 2 * threads 个批次，已经交出的批次随即释放。
+            */
+            template <class Slot, class Parse, class Deliver>
+            ParseResult parse_ordered(std::string_view content, const LinesOptions &options, Parse &&parse_batch, Deliver &&deliver)
+            {
+                std::vector<Batch> batches = split(content, options.batch_bytes);
+                const size_t n = batches.size();
+
+                const size_t threads = thread_count(options, n);
+                if (threads == 1) {
+                    for (const Batch &batch : batches) {
+                        Slot slot;
+                        parse_batch(batch, slot);
+                        ParseResult r = deliver(slot);
+                        if (r.code != ParseOk)
+                            return r;
+                    }
+                    return ParseResult{ ParseOk, content.size() };
+                }
+
+                std::vector<Slot> slots(n);
+                std::mutex mutex;
+                std::condition_variable ready, space;
+                size_t next = 0, delivered = 0;
+                bool stop = false;
+                const size_t window = 2 * threads;
+                Workers workers([&] {
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        stop = true;
+                    }
+                    space.notify_all();
+                });
+                workers.start(threads, [&](size_t) {
+                    for (;;) {
+                        size_t b;
+                        {
+                            std::unique_lock<std::mutex> lock(mutex);
+                            space.wait(lock, [&] { return stop || next >= n || next < delivered + window; });
+                            if (stop || next >= n)
+                                return;
+                            b = next++;
+                        }
+                        // 异常不能离开工作线程，否则整个进程终止：保存下来并停止领取之后的批次
+                        std::exception_ptr error;
+                        try {
+                            parse_batch(batches[b], slots[b]);
+                        } catch (...) {
+                            error = std::current_exception();
+                        }
+                        {
+                            std::lock_guard<std::mutex> lock(mutex);
+                            slots[b].error = error;
+                            slots[b].ready = true;
+                            if (error)
+                                stop = true;
+                        }
+                        ready.notify_all();
+                        if (error)
+                            space.notify_all();
+                    }
+                });
+
+                for (size_t b = 0; b < n; ++b) {
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        ready.wait(lock, [&] { return slots[b].ready; });
+                    }
+                    // 之前的批次都已交出，与单线程时一样在这里抛出
+                    if (slots[b].error)
+                        std::rethrow_exception(slots[b].error);
+                    ParseResult r = deliver(slots[b]);
+                    slots[b] = Slot();
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        delivered = b + 1;
+                    }
+                    space.notify_all();
+                    if (r.code != ParseOk)
+                        return r;
+                }
+                return ParseResult{ ParseOk, content.size() };
+            }
+
+            /* 把批次中的记录解析为 DOM */
+            ParseResult parse_records(std::string_view content, const LinesOptions &options, const std::function<ParseResult(RecordSlot &slot)> &deliver)
+            {
+                ParseOptions record_options = options.parse;
+                record_options.stats = nullptr;
+                auto parse_batch = [&](const Batch &batch, RecordSlot &slot) {
+                    slot.result = for_each_record(batch, content.data(), [&](const char *p, size_t len) {
+                        slot.records.emplace_back();
+                        ParseResult r = slot.records.back().try_parse(p, len, record_options);
+                        if (r.code != ParseOk)
+                            slot.records.pop_back();
+                        else
+                            slot.starts.push_back(static_cast<size_t>(p - content.data()));
+                        return r;
+                    });
+                };
+                return parse_ordered<RecordSlot>(content, options, parse_batch, deliver);
+            }
+        } // namespace
+
+        ParseResult parse_lines(std::string_view content, const RecordCallback &on_record, const LinesOptions &options)
+        {
+            size_t index = 0;
+            return parse_records(content, options, [&](RecordSlot &slot) {
+                for (size_t i = 0; i < slot.records.size(); ++i) {
+                    if (!on_record(index++, slot.records[i].view()))
+                        return ParseResult{ ParseCancelled, slot.starts[i] };
+                }
+                return slot.result;
+            });
+        }
+
+        ParseResult parse_lines(std::string_view content, std::vector<Json> &records, const LinesOptions &options)
+        {
+            return parse_records(content, options, [&](RecordSlot &slot) {
+                for (Json &j : slot.records)
+                    records.push_back(std::move(j));
+                return slot.result;
+            });
+        }
+
+        /* SAX：工作线程把批次的事件缓存到 EventSlot 中，调用线程按顺序重放 */
+        ParseResult parse_lines(std::string_view content, RecordHandler &handler, const LinesOptions &options)
+        {
+            ParseOptions record_options = options.parse;
+            record_options.stats = nullptr;
+            auto parse_batch = [&](const Batch &batch, EventSlot &slot) {
+                EventBuffer buffer(slot, content);
+                slot.result = for_each_record(batch, content.data(), [&](const char *p, size_t len) {
+                    buffer.on_record(static_cast<size_t>(p - content.data()));
+                    return parse(p, len, buffer, record_options);
+                });
+            };
+            return parse_ordered<EventSlot>(content, options, parse_batch, [&](const EventSlot &slot) {
+                return replay(slot, handler);
+            });
+        }
+    } // namespace json
+} // namespace yfn
@@ -0,0 +1,35 @@
+#ifndef JSON_NUMBER_H__
+#define JSON_NUMBER_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace yfn
+{
+    namespace json
+    {
+        /* parse_number 校验数字语法时记录下来的各部分位置，转换时直接复用，不再重新扫描 */
+        struct DecimalNumber
+        {
+            const char *begin;      // 整个数字的起始位置（包括负号）
+            const char *end;        // 整个数字的结束位置
+            const char *int_begin;  // 整数部分
+            const char *int_end;
+            const char *frac_begin; // 小数部分，没有小数时为空区间
+            const char *frac_end;
+            int64_t exponent;       // 指数部分的值，已限制在不会溢出的范围内
+            bool negative;
+        };
+
+        /* 将十进制数字转换为最接近的 double（正确舍入、与 locale 无关）；溢出时返回 ±HUGE_VAL */
+        double decimal_to_double(const DecimalNumber &num) noexcept;
+
+        /* 生成数字的字符串时所需缓冲区的最大长度 */
+        const size_t kMaxDoubleLength = 25;
+
+        /* 把有限的 double 格式化为能精确往返的最短十进制表示，写入 buffer 并返回结尾位置（不写入 '\0'） */
+        char* double_to_chars(double d, char *buffer) noexcept;
+    } // namespace json
+} // namespace yfn
+
+#endif
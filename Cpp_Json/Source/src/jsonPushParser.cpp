@@ -0,0 +1,313 @@
+#include "jsonPushParser.h"
+#include "jsonAlloc.h"
+#include "jsonReader.h"
+#include "jsonSimd.h"
+#include "jsonValue.h"
+#include "parser.h"
+
+namespace yfn
+{
+    namespace json
+    {
+        /* 构建 DOM 的 Handler：把事件转交给 Parser，与一次性解析构建出完全相同的树 */
+        class PushParser::DomBuilder final : public Handler
+        {
+        public:
+            DomBuilder(Value &root, const ParseOptions &options) : parser_(root, nullptr, 0, options, default_resource()) { }
+
+            bool on_null() override { return parser_.on_null(); }
+            bool on_bool(bool b) override { return parser_.on_bool(b); }
+            bool on_number(double d) override { return parser_.on_number(d); }
+            bool on_string(std::string_view s) override { return parser_.on_string(s); }
+            bool on_key(std::string_view key) override { return parser_.on_key(key); }
+            bool on_start_object() override { return parser_.on_start_object(); }
+            bool on_end_object(size_t count) override { return parser_.on_end_object(count); }
+            bool on_start_array() override { return parser_.on_start_array(); }
+            bool on_end_array(size_t count) override { return parser_.on_end_array(count); }
+        private:
+            Parser parser_;
+        };
+
+        /* 单独解析一个 key 时，Reader 把它当作字符串值，这里把 on_string 转换为 on_key */
+        struct KeyForwarder
+        {
+            Handler &handler;
+
+            bool on_string(std::string_view key) { return handler.on_key(key); }
+            bool on_null() { return false; }
+            bool on_bool(bool) { return false; }
+            bool on_number(double) { return false; }
+            bool on_key(std::string_view) { return false; }
+            bool on_start_object() { return false; }
+            bool on_end_object(size_t) { return false; }
+            bool on_start_array() { return false; }
+            bool on_end_array(size_t) { return false; }
+        };
+
+        PushParser::PushParser(Handler &handler, const ParseOptions &options) : handler_(&handler), options_(options)
+        {
+            options_.stats = nullptr;
+        }
+
+        PushParser::PushParser(Json &target, const ParseOptions &options) : handler_(nullptr), target_(&target), options_(options)
+        {
+            options_.stats = nullptr;
+            reset();
+        }
+
+        PushParser::~PushParser() noexcept = default;
+
+        void PushParser::reset()
+        {
+            if (target_ != nullptr) {
+                target_->v->set_type(json::Null);
+                dom_.reset(new DomBuilder(*target_->v, options_));
+                handler_ = dom_.get();
+            }
+            stack_.clear();
+            state_ = State::Value;
+            token_ = Token::None;
+            escape_ = false;
+            carry_.clear();
+            token_offset_ = 0;
+            chunk_ = nullptr;
+            base_ = 0;
+            error_ = ParseOk;
+            error_offset_ = 0;
+            finished_ = false;
+        }
+
+        /* 记录第一个错误，之后的调用都返回它；构建 DOM 时丢弃已经构建的部分 */
+        error PushParser::fail(error code, size_t offset) noexcept
+        {
+            error_ = code;
+            error_offset_ = offset;
+            if (target_ != nullptr)
+                target_->v->set_type(json::Null);
+            return code;
+        }
+
+        ParseResult PushParser::feed(const char *data, size_t len)
+        {
+            if (error_ != ParseOk)
+                return ParseResult{ error_, error_offset_ };
+            if (finished_)
+                return ParseResult{ fail(ParseRootNotSingular, base_), error_offset_ };
+            chunk_ = data;
+            error ret = process(data, data + len);
+            base_ += len;
+            if (ret != ParseOk)
+                return ParseResult{ error_, error_offset_ };
+            return ParseResult{ ParseOk, base_ };
+        }
+
+        ParseResult PushParser::finish()
+        {
+            if (error_ != ParseOk)
+                return ParseResult{ error_, error_offset_ };
+            if (finished_)
+                return ParseResult{ ParseOk, base_ };
+            // 输入结束时，数字与字面值自然结束；没有结束的字符串由 Reader 报告缺少引号
+            if (token_ != Token::None) {
+                std::string token;
+                token.swap(carry_);
+                if (handle_token(token.data(), token.size(), token_offset_) != ParseOk)
+                    return ParseResult{ error_, error_offset_ };
+            }
+            error ret = ParseOk;
+            switch (state_) {
+                case State::Value:
+                case State::FirstValueOrClose: ret = ParseExpectValue; break;
+                case State::FirstKeyOrClose:
+                case State::Key: ret = ParseMissKey; break;
+                case State::Colon: ret = ParseMissColon; break;
+                case State::AfterValue: ret = stack_.empty() ? ParseOk : after_value_error(); break;
+            }
+            if (ret != ParseOk)
+                return ParseResult{ fail(ret, base_), base_ };
+            finished_ = true;
+            return ParseResult{ ParseOk, base_ };
+        }
+
+        const char* PushParser::scan_token(const char *p, const char *end) noexcept
+        {
+            switch (token_) {
+                case Token::String:
+                case Token::Key:
+                    // 跳过转义的字节；结尾的引号或者非法的控制字符都结束这个词法单元，后者由 Reader 报告错误
+                    for (;;) {
+                        if (escape_) {
+                            if (p == end)
+                                return nullptr;
+                            ++p;
+                            escape_ = false;
+                        }
+                        p = scan_string(p, end);
+                        if (p == end)
+                            return nullptr;
+                        if (*p != '\\')
+                            return p + 1;
+                        escape_ = true;
+                        ++p;
+                    }
+                case Token::Number:
+                    while (p != end && ((*p >= '0' && *p <= '9') || *p == '-' || *p == '+' || *p == '.' || *p == 'e' || *p == 'E'))
+                        ++p;
+                    return p == end ? nullptr : p;
+                case Token::Literal:
+                    while (p != end && *p >= 'a' && *p <= 'z')
+                        ++p;
+                    return p == end ? nullptr : p;
+                default:
+                    return p;
+            }
+        }
+
+        error PushParser::after_value_error() const noexcept
+        {
+            if (stack_.empty())
+                return ParseRootNotSingular;
+            return stack_.back().object ? ParseMissCommaOrCurlyBracket : ParseMissCommaOrSquareBracket;
+        }
+
+        /*
+            用 Reader 解析单独的一个词法单元，错误码与偏移因此与一次性解析完全相同。
+            数字与字面值之后紧跟着的其他字母或数字（例如 "1-2"、"nullx"）使 Reader 返回 ParseRootNotSingular，
+            此时值本身已经有效，接下来的字节在任何容器中都是非法的，直接按照所在的容器报告错误。
+        */
+        error PushParser::handle_token(const char *data, size_t len, size_t base)
+        {
+            Token kind = token_;
+            token_ = Token::None;
+            ParseResult result;
+            if (kind == Token::Key) {
+                KeyForwarder forwarder{ *handler_ };
+                result = Reader<KeyForwarder>(forwarder, data, len, options_, default_resource()).parse();
+                // 与 Reader::parse_key 相同：取消与不合法的 UTF-8 照常报告，其他错误都视为缺少 key
+                if (result.code == ParseCancelled || result.code == ParseInvalidUtf8)
+                    return fail(result.code, base + result.offset);
+                if (result.code != ParseOk)
+                    return fail(ParseMissKey, base);
+                state_ = State::Colon;
+                return ParseOk;
+            }
+            result = Reader<Handler>(*handler_, data, len, options_, default_resource()).parse();
+            if (result.code != ParseOk && result.code != ParseRootNotSingular)
+                return fail(result.code, base + result.offset);
+            state_ = State::AfterValue;
+            if (result.code == ParseRootNotSingular)
+                return fail(after_value_error(), base + result.offset);
+            return ParseOk;
+        }
+
+        error PushParser::process(const char *p, const char *end)
+        {
+            // 先把上一块中没有结束的词法单元接上
+            if (token_ != Token::None) {
+                const char *e = scan_token(p, end);
+                if (e == nullptr) {
+                    carry_.append(p, end);
+                    return ParseOk;
+                }
+                carry_.append(p, e);
+                std::string token;
+                token.swap(carry_);
+                error ret = handle_token(token.data(), token.size(), token_offset_);
+                token.clear();
+                carry_.swap(token);     // 保留 carry_ 的容量
+                if (ret != ParseOk)
+                    return ret;
+                p = e;
+            }
+            while (p != end) {
+                char ch = *p;
+                if (ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r') {
+                    ++p;
+                    continue;
+                }
+                switch (state_) {
+                    case State::FirstValueOrClose:
+                        if (ch == ']') {
+                            stack_.pop_back();
+                            state_ = State::AfterValue;
+                            if (!handler_->on_end_array(0)) return fail(ParseCancelled, at(p + 1));
+                            ++p;
+                            continue;
+                        }
+                        stack_.back().count = 1;
+                        state_ = State::Value;
+                        continue;
+                    case State::FirstKeyOrClose:
+                        if (ch == '}') {
+                            stack_.pop_back();
+                            state_ = State::AfterValue;
+                            if (!handler_->on_end_object(0)) return fail(ParseCancelled, at(p + 1));
+                            ++p;
+                            continue;
+                        }
+                        stack_.back().count = 1;
+                        state_ = State::Key;
+                        continue;
+                    case State::Colon:
+                        if (ch != ':') return fail(ParseMissColon, at(p));
+                        state_ = State::Value;
+                        ++p;
+                        continue;
+                    case State::AfterValue:
+                        if (stack_.empty()) return fail(ParseRootNotSingular, at(p));
+                        if (ch == ',') {
+                            ++stack_.back().count;
+                            state_ = stack_.back().object ? State::Key : State::Value;
+                            ++p;
+                            continue;
+                        }
+                        if (ch == (stack_.back().object ? '}' : ']')) {
+                            Frame top = stack_.back();
+                            stack_.pop_back();
+                            bool go_on = top.object ? handler_->on_end_object(top.count) : handler_->on_end_array(top.count);
+                            if (!go_on) return fail(ParseCancelled, at(p + 1));
+                            ++p;
+                            continue;
+                        }
+                        return fail(after_value_error(), at(p));
+                    case State::Key:
+                        if (ch != '\"') return fail(ParseMissKey, at(p));
+                        token_ = Token::Key;
+                        break;
+                    case State::Value:
+                        if (ch == '[' || ch == '{') {
+                            if (stack_.size() >= options_.max_depth) return fail(ParseDepthExceeded, at(p));
+                            bool object = (ch == '{');
+                            stack_.push_back(Frame{ object, 0 });
+                            state_ = object ? State::FirstKeyOrClose : State::FirstValueOrClose;
+                            if (!(object ? handler_->on_start_object() : handler_->on_start_array()))
+                                return fail(ParseCancelled, at(p + 1));
+                            ++p;
+                            continue;
+                        }
+                        if (ch == '\"')
+                            token_ = Token::String;
+                        else if (ch == 'n' || ch == 't' || ch == 'f')
+                            token_ = Token::Literal;
+                        else if (ch == '-' || (ch >= '0' && ch <= '9'))
+                            token_ = Token::Number;
+                        else
+                            return fail(ParseInvalidValue, at(p));
+                        break;
+                }
+                // 开始一个词法单元：在本块中结束的直接解析，否则保存到 carry_ 中等待下一块
+                const char *start = p;
+                const char *e = scan_token(token_ == Token::String || token_ == Token::Key ? p + 1 : p, end);
+                if (e == nullptr) {
+                    carry_.assign(start, end);
+                    token_offset_ = at(start);
+                    return ParseOk;
+                }
+                if (handle_token(start, static_cast<size_t>(e - start), at(start)) != ParseOk)
+                    return error_;
+                p = e;
+            }
+            return ParseOk;
+        }
+    } // namespace json
+} // namespace yfn
@@ -0,0 +1,493 @@
+#ifndef JSON_READER_H__
+#define JSON_READER_H__
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "json.h"
+#include "jsonNumber.h"
+#include "jsonSimd.h"
+
+namespace yfn
+{
+    namespace json
+    {
+        /*
+            标量的词法分析：字面值、数字与字符串，以及空白的跳过与出错位置的记录。
+            逐字符解析的 Reader 与沿着结构索引解析的 StructuralReader（见 jsonStructural.h）共用这些函数，两者的错误码与出错位置因此完全相同。
+        */
+        class Lexer
+        {
+        protected:
+            Lexer(const char *data, size_t len, const ParseOptions &options, std::pmr::memory_resource *resource)
+                : begin_(data), cur_(data), end_(data + len), scratch_(resource),
+                  utf8_checked_(options.validate_utf8 ? data : data + len), utf8_valid_end_(utf8_checked_)
+            {
+            }
+
+            /* 记录出错的位置，然后返回错误码 */
+            error fail(const char *pos, error code) noexcept
+            {
+                cur_ = pos;
+                return code;
+            }
+
+            /* 若当前字符为 ch，则跳过该字符并返回 true；到达输入末尾时返回 false */
+            bool consume(char ch) noexcept
+            {
+                if (cur_ != end_ && *cur_ == ch) {
+                    ++cur_;
+                    return true;
+                }
+                return false;
+            }
+
+            /* 过滤掉 json 字符串中的空白，即空格符、制表符、换行符、回车符 */
+            void parse_whitespace() noexcept
+            {
+                cur_ = skip_whitespace(cur_, end_);
+            }
+
+            /* 合并 false、true、null 的解析：剩余的字节不足或者与字面值不相同，解析失败 */
+            error parse_literal(const char *literal, size_t len) noexcept
+            {
+                if (static_cast<size_t>(end_ - cur_) < len || memcmp(cur_, literal, len) != 0)
+                    return ParseInvalidValue;
+                cur_ += len;
+                return ParseOk;
+            }
+
+            /* 判断是否为数字字符，不依赖 locale */
+            static bool is_digit(char ch) noexcept
+            {
+                return ch >= '0' && ch <= '9';
+            }
+
+            /* 解析数字：校验语法的同时记录下整数、小数、指数各部分的位置，交给 decimal_to_double 直接转换，不再调用 strtod 重新扫描 */
+            error parse_number(double &d) noexcept
+            {
+                DecimalNumber num;
+                const char *p = cur_, *end = end_;
+                num.begin = p;
+                // 处理负号
+                num.negative = (*p == '-');
+                if(num.negative) p++;
+
+                // 处理整数部分，分为两种合法情况：一种是单个 0，另一种是一个 1~9 再加上任意数量的 digit。
+                num.int_begin = p;
+                if(p != end && *p == '0') p++;
+                else {
+                    if(p == end || !is_digit(*p)) return ParseInvalidValue;
+                    do ++p; while(p != end && is_digit(*p));
+                }
+                num.int_end = p;
+
+                // 处理小数部分：小数点后面第一个数不是数字，则解析失败，然后再处理连续的数字
+                num.frac_begin = num.frac_end = p;
+                if(p != end && *p == '.'){
+                    if(++p == end || !is_digit(*p)) return ParseInvalidValue;
+                    num.frac_begin = p;
+                    do ++p; while(p != end && is_digit(*p));
+                    num.frac_end = p;
+                }
+
+                // 处理指数部分：需要处理指数的符号，符号之后的第一个字符不是数字，则解析失败；然后再处理连续的数字
+                num.exponent = 0;
+                if(p != end && (*p == 'e' || *p == 'E')){
+                    ++p;
+                    bool negative_exp = false;
+                    if(p != end && (*p == '+' || *p == '-')) negative_exp = (*p++ == '-');
+                    if(p == end || !is_digit(*p)) return ParseInvalidValue;
+                    // 指数超过一定范围之后结果必然是无穷大或 0，限制其大小以免溢出
+                    do {
+                        if(num.exponent < 0x10000000) num.exponent = num.exponent * 10 + (*p - '0');
+                    } while(++p != end && is_digit(*p));
+                    if(negative_exp) num.exponent = -num.exponent;
+                }
+                num.end = p;
+
+                // 将 json 的十进制数字转换为 double 型的二进制数字，如果转换出来的数字过大，则解析失败
+                d = decimal_to_double(num);
+                if (d == HUGE_VAL || d == -HUGE_VAL)
+                    return ParseNumberTooBig;
+                cur_ = p;
+                return ParseOk;
+            }
+
+            /*
+                开启了 UTF-8 校验时，检查字符串中以 q 结尾的一段字节：整个输入按窗口在解析到达之前校验，这里通常只需要比较一次指针。
+                json 文本在字符串之外只可能出现 ASCII 字节，其他字节在解析到那里时就是语法错误，因此只有落在字符串中的不合法序列才报告为 ParseInvalidUtf8。
+            */
+            bool valid_utf8(const char *q) noexcept
+            {
+                return q <= utf8_valid_end_ || extend_utf8(q);
+            }
+
+            /* 向后逐个窗口地校验，直到覆盖 q 或者发现不合法的序列 */
+            bool extend_utf8(const char *q) noexcept
+            {
+                while (utf8_valid_end_ < q) {
+                    // 已经校验过的窗口中有不合法的序列，utf8_valid_end_ 就是它的开头
+                    if (utf8_valid_end_ != utf8_checked_) {
+                        cur_ = utf8_valid_end_;
+                        return false;
+                    }
+                    const char *window_end = end_ - utf8_checked_ > kUtf8Window ? utf8_checked_ + kUtf8Window : end_;
+                    // 窗口不在一个字符的中间结束，最多向前退 3 个 10xxxxxx 的字节
+                    for (int i = 0; i < 3 && window_end != end_ && (static_cast<unsigned char>(*window_end) & 0xC0) == 0x80; ++i)
+                        --window_end;
+                    utf8_valid_end_ = kernels().validate_utf8(utf8_checked_, window_end);
+                    utf8_checked_ = window_end;
+                }
+                return true;
+            }
+
+            /*
+                解析字符串：用 SIMD 一次比较 16/32 个字节找到下一个需要处理的字节。
+                第一个需要处理的字节就是结尾的引号时，字符串中没有转义，直接返回指向输入的 string_view；否则解码到 scratch_ 中。
+            */
+            error parse_string(std::string_view &out)
+            {
+                assert(*cur_ == '\"');
+                const char *p = ++cur_;// 跳过字符串的第一个引号
+                const char *q = scan_string(p, end_);
+                if (q != end_ && *q == '\"') {
+                    if (!valid_utf8(q))
+                        return ParseInvalidUtf8;
+                    out = std::string_view(p, q - p);
+                    cur_ = q + 1;
+                    return ParseOk;
+                }
+                scratch_.clear();
+                unsigned u = 0, u2 = 0;
+                for (;;)
+                {
+                    // 把之前不需要转义的一段字节整体追加到 scratch_ 中
+                    if (!valid_utf8(q))
+                        return ParseInvalidUtf8;
+                    scratch_.append(p, q);
+                    p = q;
+                    // 到达输入末尾仍未遇到第二个引号，说明该字符串缺少引号
+                    if (p == end_)
+                        return fail(p, ParseMissQuotationMark);
+                    // 解析到字符串结尾，也就是第二个引号
+                    if (*p == '\"')
+                        break;
+                    // 处理 9 种转义字符：当前字符是'\'，然后跳到下一个字符
+                    if (*p == '\\')
+                    {
+                        const char *escape = p++;
+                        if (p == end_)
+                            return fail(escape, ParseInvalidStringEscape);
+                        switch (*p++)
+                        {
+                        case '\"': scratch_ += '\"' ; break;
+                        case '\\': scratch_ += '\\' ; break;
+                        case '/' : scratch_ += '/'  ; break;
+                        case 'b' : scratch_ += '\b' ; break;
+                        case 'f' : scratch_ += '\f' ; break;
+                        case 'n' : scratch_ += '\n' ; break;
+                        case 'r' : scratch_ += '\r' ; break;
+                        case 't' : scratch_ += '\t' ; break;
+                        case 'u' :
+                            // 遇到\u转义时，调用parse_hex4()来解析4位十六进制数字
+                            if (!parse_hex4(p, u))
+                                return fail(escape, ParseInvalidUnicodeHex);
+                            if (u >= 0xD800 && u <= 0xDBFF)
+                            {
+                                if (end_ - p < 2 || p[0] != '\\' || p[1] != 'u')
+                                    return fail(escape, ParseInvalidUnicodeSurrogate);
+                                p += 2;
+                                if (!parse_hex4(p, u2))
+                                    return fail(escape, ParseInvalidUnicodeHex);
+                                if (u2 < 0xDC00 || u2 > 0xDFFF)
+                                    return fail(escape, ParseInvalidUnicodeSurrogate);
+                                u = (((u - 0xD800) << 10) | (u2 - 0xDC00)) + 0x10000;
+                            }
+                            // 把码点编码成 utf-8，写进缓冲区
+                            encode_utf8(u);
+                            break;
+                        default : return fail(escape, ParseInvalidStringEscape);
+                        }
+                    }
+                    // 剩下的只可能是小于 0x20 的控制字符
+                    else return fail(p, ParseInvalidStringChar);
+                    q = scan_string(p, end_);
+                }
+                // 更新当前字符串的位置
+                cur_ = ++p;
+                out = scratch_;
+                return ParseOk;
+            }
+
+            /* 读4位16进制数字，剩余字节不足或遇到非十六进制字符时返回 false */
+            bool parse_hex4(const char* &p, unsigned &u) const noexcept
+            {
+                if (end_ - p < 4)
+                    return false;
+                u = 0;
+                for (size_t i = 0; i < 4; ++i)
+                {
+                    char ch = *p++;
+                    u <<= 4;
+                    if (is_digit(ch))
+                        u |= ch - '0';
+                    else if (ch >= 'A' && ch <= 'F')
+                        u |= ch - ('A' - 10);
+                    else if (ch >= 'a' && ch <= 'f')
+                        u |= ch - ('a' - 10);
+                    else return false;
+                }
+                return true;
+            }
+
+            /* 把码点编码成 utf-8 */
+            void encode_utf8(unsigned u)
+            {
+                if (u <= 0x7F)
+                    scratch_ += static_cast<char> (u & 0xFF);
+                else if (u <= 0x7FF) {
+                    scratch_ += static_cast<char> (0xC0 | ((u >> 6) & 0xFF));
+                    scratch_ += static_cast<char> (0x80 | ( u       & 0x3F));
+                }
+                else if (u <= 0xFFFF) {
+                    scratch_ += static_cast<char> (0xE0 | ((u >> 12) & 0xFF));
+                    scratch_ += static_cast<char> (0x80 | ((u >>  6) & 0x3F));
+                    scratch_ += static_cast<char> (0x80 | ( u        & 0x3F));
+                }
+                else {
+                    assert(u <= 0x10FFFF);
+                    scratch_ += static_cast<char> (0xF0 | ((u >> 18) & 0xFF));
+                    scratch_ += static_cast<char> (0x80 | ((u >> 12) & 0x3F));
+                    scratch_ += static_cast<char> (0x80 | ((u >>  6) & 0x3F));
+                    scratch_ += static_cast<char> (0x80 | ( u        & 0x3F));
+                }
+            }
+
+            const char *begin_;
+            const char *cur_;
+            const char *end_;
+            /* 解码含转义的字符串的缓冲区，在整个解析过程中复用 */
+            std::pmr::string scratch_;
+            /*
+                UTF-8 的校验（见 ParseOptions::validate_utf8）：[begin_, utf8_checked_) 已经校验过，其中 [begin_, utf8_valid_end_) 合法；
+                不校验时两者都是输入的末尾。每次校验 kUtf8Window 字节，窗口留在缓存中，紧接着的解析还会读到它。
+            */
+            static constexpr ptrdiff_t kUtf8Window = 64 * 1024;
+            const char *utf8_checked_;
+            const char *utf8_valid_end_;
+        };
+
+        /*
+            json 文本的词法与语法分析，每识别出一个值就调用一次 Handler 的事件函数，自己不构建任何树。
+            Handler 需要提供与 json::Handler 同名的成员函数（不必是虚函数），返回 false 时停止解析并返回 ParseCancelled：
+                on_null()、on_bool(bool)、on_number(double)、on_string(std::string_view)、on_key(std::string_view)、
+                on_start_object()、on_end_object(size_t)、on_start_array()、on_end_array(size_t)
+            没有转义字符的字符串直接以指向输入的 string_view 传给 Handler，含转义的字符串解码到内部的缓冲区中，
+            两者都只在事件函数返回之前有效。构建 DOM 的 Parser 与用户的 json::Handler 都通过这个模板实现。
+        */
+        template <class Handler>
+        class Reader final : private Lexer
+        {
+        public:
+            /* 解析 [data, data + len) 中的 json 文本；解码字符串的缓冲区与容器栈从 resource 中分配 */
+            Reader(Handler &handler, const char *data, size_t len, const ParseOptions &options, std::pmr::memory_resource *resource)
+                : Lexer(data, len, options, resource), handler_(handler), stack_(resource),
+                  max_depth_(options.max_depth)
+            {
+            }
+
+            /* 解析整个 json 文本，失败时返回错误码与出错位置 */
+            ParseResult parse()
+            {
+                // 去掉前后的空白，若 json 在一个值之后，空白之后还有其他字符的话，说明该 json 值是不合法的。
+                parse_whitespace();
+                error ret = parse_value();
+                if (ret == ParseOk) {
+                    parse_whitespace();
+                    if (cur_ != end_)
+                        ret = ParseRootNotSingular;
+                }
+                return ParseResult{ ret, static_cast<size_t>(cur_ - begin_) };
+            }
+        private:
+            /* 尚未闭合的数组或对象，以及其中已经解析的元素个数 */
+            struct Frame
+            {
+                bool object;
+                size_t count;
+            };
+
+            /*
+                解析 json 值：不递归调用，而是用 stack_ 记录当前所有尚未闭合的数组与对象。
+                一个值解析完成后，再根据栈顶容器决定是继续解析下一个元素还是闭合容器。
+            */
+            error parse_value()
+            {
+                error ret;
+                stack_.clear();
+                for (;;) {
+                    /* 1、解析一个 json 值：标量直接产生事件，容器则压栈后转去解析第一个子节点 */
+                    if (cur_ == end_)
+                        return ParseExpectValue;
+                    switch (*cur_)
+                    {
+                    case 'n':
+                        if ((ret = parse_literal("null", 4)) == ParseOk && !handler_.on_null()) return ParseCancelled;
+                        break;
+                    case 't':
+                        if ((ret = parse_literal("true", 4)) == ParseOk && !handler_.on_bool(true)) return ParseCancelled;
+                        break;
+                    case 'f':
+                        if ((ret = parse_literal("false", 5)) == ParseOk && !handler_.on_bool(false)) return ParseCancelled;
+                        break;
+                    default: {
+                            double d;
+                            if ((ret = parse_number(d)) == ParseOk && !handler_.on_number(d)) return ParseCancelled;
+                        }
+                        break;
+                    case '\"': {
+                            std::string_view s;
+                            if ((ret = parse_string(s)) == ParseOk && !handler_.on_string(s)) return ParseCancelled;
+                        }
+                        break;
+                    case '[':
+                        if (stack_.size() >= max_depth_) return ParseDepthExceeded;
+                        ++cur_;
+                        if (!handler_.on_start_array()) return ParseCancelled;
+                        parse_whitespace();
+                        if (consume(']')) { // 空数组
+                            if (!handler_.on_end_array(0)) return ParseCancelled;
+                            ret = ParseOk;
+                            break;
+                        }
+                        stack_.push_back(Frame{ false, 1 });
+                        continue;
+                    case '{':
+                        if (stack_.size() >= max_depth_) return ParseDepthExceeded;
+                        ++cur_;
+                        if (!handler_.on_start_object()) return ParseCancelled;
+                        parse_whitespace();
+                        if (consume('}')) { // 空对象
+                            if (!handler_.on_end_object(0)) return ParseCancelled;
+                            ret = ParseOk;
+                            break;
+                        }
+                        stack_.push_back(Frame{ true, 1 });
+                        if ((ret = parse_key()) != ParseOk)
+                            return ret;
+                        continue;
+                    }
+                    if (ret != ParseOk)
+                        return ret;
+
+                    /* 2、一个值解析完成：处理栈顶容器中的逗号或右括号，直到需要解析下一个值或者栈为空 */
+                    for (;;) {
+                        if (stack_.empty())
+                            return ParseOk;
+                        Frame &top = stack_.back();
+                        parse_whitespace();
+                        if (!top.object) {
+                            if (consume(',')) {
+                                parse_whitespace();
+                                ++top.count;
+                                break;
+                            }
+                            else if (consume(']')) {
+                                size_t count = top.count;
+                                stack_.pop_back();
+                                if (!handler_.on_end_array(count)) return ParseCancelled;
+                            }
+                            else
+                                return ParseMissCommaOrSquareBracket;
+                        }
+                        else {
+                            if (consume(',')) {
+                                parse_whitespace();
+                                ++top.count;
+                                if ((ret = parse_key()) != ParseOk)
+                                    return ret;
+                                break;
+                            }
+                            else if (consume('}')) {
+                                size_t count = top.count;
+                                stack_.pop_back();
+                                if (!handler_.on_end_object(count)) return ParseCancelled;
+                            }
+                            else
+                                return ParseMissCommaOrCurlyBracket;
+                        }
+                    }
+                }
+            }
+
+            /* 解析对象成员的 "key_:_"：key 不是字符串或者字符串不合法时，都视为缺少 key；只有不合法的 UTF-8 照常报告 */
+            error parse_key()
+            {
+                if (cur_ == end_ || *cur_ != '\"') return ParseMissKey;
+                const char *start = cur_;
+                std::string_view key;
+                error ret = parse_string(key);
+                if (ret == ParseInvalidUtf8)
+                    return ret;
+                if (ret != ParseOk)
+                    return fail(start, ParseMissKey);
+                if (!handler_.on_key(key)) return ParseCancelled;
+
+                // 解析"_:_"，冒号前后可有空白字符
+                parse_whitespace();
+                if (!consume(':')) return ParseMissColon;
+                parse_whitespace();
+                return ParseOk;
+            }
+
+            Handler &handler_;
+            /* 尚未闭合的数组与对象，栈的大小即当前的嵌套深度 */
+            std::pmr::vector<Frame> stack_;
+            size_t max_depth_;
+        };
+
+        /* 包装另一个 Handler，转发事件的同时填写 ParseStats 中的节点个数、嵌套深度与字符串字节数 */
+        template <class Handler>
+        class StatsHandler final
+        {
+        public:
+            StatsHandler(Handler &inner, ParseStats &stats) noexcept : inner_(inner), stats_(stats) { }
+
+            bool on_null() { ++stats_.nodes[json::Null]; return inner_.on_null(); }
+            bool on_bool(bool b) { ++stats_.nodes[b ? json::True : json::False]; return inner_.on_bool(b); }
+            bool on_number(double d) { ++stats_.nodes[json::Number]; return inner_.on_number(d); }
+            bool on_string(std::string_view s)
+            {
+                ++stats_.nodes[json::String];
+                stats_.string_bytes += s.size();
+                return inner_.on_string(s);
+            }
+            bool on_key(std::string_view key)
+            {
+                stats_.key_bytes += key.size();
+                return inner_.on_key(key);
+            }
+            bool on_start_object() { ++stats_.nodes[json::Object]; enter(); return inner_.on_start_object(); }
+            bool on_end_object(size_t count) { --depth_; return inner_.on_end_object(count); }
+            bool on_start_array() { ++stats_.nodes[json::Array]; enter(); return inner_.on_start_array(); }
+            bool on_end_array(size_t count) { --depth_; return inner_.on_end_array(count); }
+        private:
+            void enter() noexcept
+            {
+                if (++depth_ > stats_.max_depth)
+                    stats_.max_depth = depth_;
+            }
+
+            Handler &inner_;
+            ParseStats &stats_;
+            size_t depth_ = 0;
+        };
+    } // namespace json
+} // namespace yfn
+
+#endif
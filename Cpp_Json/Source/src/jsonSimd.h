@@ -0,0 +1,68 @@
+#ifndef JSON_SIMD_H__
+#define JSON_SIMD_H__
+
+#include <stdint.h>
+#include "jsonKernels.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace yfn
+{
+    namespace json
+    {
+        /* 字符串中需要特殊处理的字节：双引号、反斜杠以及小于 0x20 的控制字符 */
+        inline bool is_string_special(unsigned char ch) noexcept
+        {
+            return ch == '\"' || ch == '\\' || ch < 0x20;
+        }
+
+        inline bool is_whitespace(char ch) noexcept
+        {
+            return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r';
+        }
+
+        /*
+            在 [p, end) 中寻找第一个需要特殊处理的字节，返回其位置；没有找到时返回 end。
+            大多数字符串都很短：第一个 16 字节块在这里直接用 SSE2 比较，更长的部分交给按 CPU 选择的实现（见 jsonKernels.h）。
+            不会读取 end 之后的任何字节，输入也不需要以 '\0' 结尾。
+        */
+        inline const char* scan_string(const char *p, const char *end) noexcept
+        {
+#if defined(__SSE2__)
+            if (end - p >= 16) {
+                const __m128i ctrl = _mm_set1_epi8(0x1F);
+                __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                // max(s, 0x1F) == 0x1F 当且仅当 s <= 0x1F（无符号比较）
+                __m128i m = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(s, _mm_set1_epi8('\"')), _mm_cmpeq_epi8(s, _mm_set1_epi8('\\'))),
+                    _mm_cmpeq_epi8(_mm_max_epu8(s, ctrl), ctrl));
+                unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(m));
+                if (mask != 0)
+                    return p + __builtin_ctz(mask);
+                return kernels().scan_string(p + 16, end);
+            }
+            for (; p != end; ++p) {
+                if (is_string_special(static_cast<unsigned char>(*p)))
+                    return p;
+            }
+            return end;
+#else
+            return kernels().scan_string(p, end);
+#endif
+        }
+
+        /* 跳过空白：紧凑的文本中多数位置没有或只有一个空白，在这里直接判断；更长的空白（例如缩进）交给按 CPU 选择的实现 */
+        inline const char* skip_whitespace(const char *p, const char *end) noexcept
+        {
+            if (p == end || !is_whitespace(*p))
+                return p;
+            if (++p == end || !is_whitespace(*p))
+                return p;
+            return kernels().skip_whitespace(p + 1, end);
+        }
+    } // namespace json
+} // namespace yfn
+
+#endif
@@ -0,0 +1,40 @@
+#include <errno.h>
+#include <unistd.h>
+#include "jsonSink.h"
+
+namespace yfn
+{
+    namespace json
+    {
+        bool FdSink::write(const char *data, size_t len)
+        {
+            while (len > 0) {
+                ssize_t n = ::write(fd_, data, len);
+                if (n < 0) {
+                    if (errno == EINTR)
+                        continue;
+                    return false;
+                }
+                data += n;
+                len -= static_cast<size_t>(n);
+            }
+            return true;
+        }
+
+        bool FileSink::write(const char *data, size_t len)
+        {
+            return std::fwrite(data, 1, len, file_) == len;
+        }
+
+        bool OStreamSink::write(const char *data, size_t len)
+        {
+            os_.write(data, static_cast<std::streamsize>(len));
+            return bool(os_);
+        }
+
+        bool CallbackSink::write(const char *data, size_t len)
+        {
+            return callback_ && callback_(data, len);
+        }
+    } // namespace json
+} // namespace yfn
@@ -0,0 +1,23 @@
+#include "jsonStructural.h"
+
+namespace yfn
+{
+    namespace json
+    {
+        /* 分类与生成索引由按 CPU 选择的实现完成（见 jsonKernels.h），这里只负责按窗口推进 */
+        void StructuralIndexer::refill() noexcept
+        {
+            pos_ = count_ = 0;
+            while (count_ == 0) {
+                if (offset_ >= len_) {
+                    // 输入已经全部处理完，之后总是返回输入的末尾
+                    index_[count_++] = static_cast<uint32_t>(len_);
+                    return;
+                }
+                size_t window_end = offset_ + kWindow < len_ ? offset_ + kWindow : len_;
+                count_ = kernels().index_structurals(data_, offset_, window_end, len_, state_, index_);
+                offset_ = window_end;
+            }
+        }
+    } // namespace json
+} // namespace yfn
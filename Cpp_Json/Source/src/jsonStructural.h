@@ -0,0 +1,231 @@
+#ifndef JSON_STRUCTURAL_H__
+#define JSON_STRUCTURAL_H__
+
+#include <stdint.h>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+#include "json.h"
+#include "jsonKernels.h"
+#include "jsonReader.h"
+
+namespace yfn
+{
+    namespace json
+    {
+        /*
+            第一阶段：每次把 64 个字节分类成结构字符（{}[],:）、引号、反斜杠与空白，得到 64 位的掩码，
+            用位运算找出被反斜杠转义的字节，再对没有被转义的引号做前缀异或得到字符串内部的区域，
+            最后输出字符串之外的结构字符、每个字符串开头的引号以及每一段字面值或数字的第一个字节的位置。
+            索引按窗口分批生成，第二阶段取完一个窗口再生成下一个，索引占用的内存与输入的长度无关。各个指令集的实现见 jsonKernelsImpl.h。
+        */
+        class StructuralIndexer
+        {
+        public:
+            StructuralIndexer(const char *data, size_t len) noexcept : data_(data), len_(len) { }
+
+            /* 下一个结构字符的位置，不前进；全部取完之后返回输入的末尾 */
+            const char* peek() noexcept
+            {
+                if (pos_ == count_)
+                    refill();
+                return data_ + index_[pos_];
+            }
+
+            /* 取出下一个结构字符的位置 */
+            const char* next() noexcept
+            {
+                const char *p = peek();
+                ++pos_;
+                return p;
+            }
+        private:
+            /* 每个窗口的字节数，必须是 64 的倍数；索引最多每个字节一项，另外留出一次多写的余量 */
+            static constexpr size_t kWindow = 4096;
+            static constexpr size_t kSlack = 4;
+
+            /* 为下一个窗口生成索引 */
+            void refill() noexcept;
+
+            const char *data_;
+            size_t len_;
+            size_t offset_ = 0;             // 下一个窗口的开头
+            IndexState state_;
+            size_t pos_ = 0, count_ = 0;
+            uint32_t index_[kWindow + kSlack];
+        };
+
+        /*
+            第二阶段：沿着结构索引解析，语法与事件的顺序都与 Reader 相同，标量仍由 Lexer 解析。
+            结构字符之间只可能是空白，因此不再逐个字节地跳过空白：标量结束之后，要么紧跟着下一个结构字符，要么紧跟着空白。
+            出错时用不产生事件的 Reader 重新定位，错误码与出错位置与 Reader 完全相同；Handler 返回 false 时直接停止。
+        */
+        template <class Handler>
+        class StructuralReader final : private Lexer
+        {
+        public:
+            StructuralReader(Handler &handler, const char *data, size_t len, const ParseOptions &options, std::pmr::memory_resource *resource)
+                : Lexer(data, len, options, resource), handler_(handler), indexer_(data, len), stack_(resource), options_(options), resource_(resource)
+            {
+            }
+
+            ParseResult parse()
+            {
+                error ret = parse_value();
+                if (ret == ParseCancelled)
+                    return ParseResult{ ret, static_cast<size_t>(cur_ - begin_) };
+                if (ret != ParseOk)
+                    return diagnose();
+                return ParseResult{ ParseOk, static_cast<size_t>(end_ - begin_) };
+            }
+        private:
+            struct Frame
+            {
+                bool object;
+                size_t count;
+            };
+
+            /* 不产生任何事件的 Handler，只用于出错时重新定位错误 */
+            struct NullHandler
+            {
+                bool on_null() { return true; }
+                bool on_bool(bool) { return true; }
+                bool on_number(double) { return true; }
+                bool on_string(std::string_view) { return true; }
+                bool on_key(std::string_view) { return true; }
+                bool on_start_object() { return true; }
+                bool on_end_object(size_t) { return true; }
+                bool on_start_array() { return true; }
+                bool on_end_array(size_t) { return true; }
+            };
+
+            ParseResult diagnose()
+            {
+                NullHandler null;
+                ParseResult result = Reader<NullHandler>(null, begin_, static_cast<size_t>(end_ - begin_), options_, resource_).parse();
+                assert(result.code != ParseOk);
+                return result;
+            }
+
+            /* 标量之后只能紧跟着下一个结构字符、空白或者输入的末尾，否则例如 "1x"、"nullx" 不合法 */
+            bool scalar_ended() noexcept
+            {
+                return cur_ == indexer_.peek() || (cur_ != end_ && is_whitespace(*cur_));
+            }
+
+            /* 解析对象成员的 key 以及其后的冒号，p 指向 key 的引号 */
+            error parse_key(const char *p)
+            {
+                if (p == end_ || *p != '\"') return ParseMissKey;
+                cur_ = p;
+                std::string_view key;
+                if (parse_string(key) != ParseOk) return ParseMissKey;
+                if (!handler_.on_key(key)) return ParseCancelled;
+                if (!scalar_ended()) return ParseMissColon;
+                p = indexer_.next();
+                if (p == end_ || *p != ':') return ParseMissColon;
+                return ParseOk;
+            }
+
+            error parse_value()
+            {
+                error ret;
+                const char *p = indexer_.next();
+                for (;;) {
+                    /* 1、p 指向一个值的开头 */
+                    if (p == end_)
+                        return ParseExpectValue;
+                    cur_ = p;
+                    switch (*p)
+                    {
+                    case 'n':
+                        if ((ret = parse_literal("null", 4)) != ParseOk) return ret;
+                        if (!handler_.on_null()) return ParseCancelled;
+                        break;
+                    case 't':
+                        if ((ret = parse_literal("true", 4)) != ParseOk) return ret;
+                        if (!handler_.on_bool(true)) return ParseCancelled;
+                        break;
+                    case 'f':
+                        if ((ret = parse_literal("false", 5)) != ParseOk) return ret;
+                        if (!handler_.on_bool(false)) return ParseCancelled;
+                        break;
+                    default: {
+                            double d;
+                            if ((ret = parse_number(d)) != ParseOk) return ret;
+                            if (!handler_.on_number(d)) return ParseCancelled;
+                        }
+                        break;
+                    case '\"': {
+                            std::string_view s;
+                            if ((ret = parse_string(s)) != ParseOk) return ret;
+                            if (!handler_.on_string(s)) return ParseCancelled;
+                        }
+                        break;
+                    case '[':
+                        if (stack_.size() >= options_.max_depth) return ParseDepthExceeded;
+                        cur_ = p + 1;
+                        if (!handler_.on_start_array()) return ParseCancelled;
+                        p = indexer_.next();
+                        if (p != end_ && *p == ']') {
+                            cur_ = p + 1;
+                            if (!handler_.on_end_array(0)) return ParseCancelled;
+                            goto value_done;
+                        }
+                        stack_.push_back(Frame{ false, 1 });
+                        continue;
+                    case '{':
+                        if (stack_.size() >= options_.max_depth) return ParseDepthExceeded;
+                        cur_ = p + 1;
+                        if (!handler_.on_start_object()) return ParseCancelled;
+                        p = indexer_.next();
+                        if (p != end_ && *p == '}') {
+                            cur_ = p + 1;
+                            if (!handler_.on_end_object(0)) return ParseCancelled;
+                            goto value_done;
+                        }
+                        stack_.push_back(Frame{ true, 1 });
+                        if ((ret = parse_key(p)) != ParseOk) return ret;
+                        p = indexer_.next();
+                        continue;
+                    }
+                    if (!scalar_ended())
+                        return ParseInvalidValue;
+                value_done:
+                    /* 2、一个值解析完成：处理栈顶容器中的逗号或右括号，直到需要解析下一个值或者栈为空 */
+                    for (;;) {
+                        p = indexer_.next();
+                        if (stack_.empty())
+                            return p == end_ ? ParseOk : ParseRootNotSingular;
+                        Frame &top = stack_.back();
+                        if (p == end_)
+                            return ParseExpectValue;
+                        if (*p == ',') {
+                            ++top.count;
+                            if (top.object) {
+                                if ((ret = parse_key(indexer_.next())) != ParseOk) return ret;
+                            }
+                            p = indexer_.next();
+                            break;
+                        }
+                        if (*p != (top.object ? '}' : ']'))
+                            return ParseInvalidValue;
+                        cur_ = p + 1;
+                        size_t count = top.count;
+                        bool object = top.object;
+                        stack_.pop_back();
+                        if (!(object ? handler_.on_end_object(count) : handler_.on_end_array(count))) return ParseCancelled;
+                    }
+                }
+            }
+
+            Handler &handler_;
+            StructuralIndexer indexer_;
+            std::pmr::vector<Frame> stack_;
+            const ParseOptions &options_;
+            std::pmr::memory_resource *resource_;
+        };
+    } // namespace json
+} // namespace yfn
+
+#endif
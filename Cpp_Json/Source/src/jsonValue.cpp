@@ -1,8 +1,11 @@
 #include <assert.h>
+#include <stdint.h>
+#include <functional>
 #include <string>
 #include "jsonValue.h"
 #include "parser.h"
 #include "jsonGenerator.h"
+#include "jsonException.h"
 
 namespace yfn
 {
@@ -16,13 +19,24 @@ namespace yfn
             return *this;
         }
 
+        /* 移动赋值：先把 rhs 移到临时值中，避免 rhs 是自身子节点时被 free() 提前释放 */
+        Value& Value::operator=(Value &&rhs) noexcept
+        {
+            if(this != &rhs){
+                Value tmp(std::move(rhs));
+                free();
+                init(std::move(tmp));
+            }
+            return *this;
+        }
+
         /* 析构函数 */
         Value::~Value() noexcept
         {
             free();
         }
 
-        /* 初始化 Value 的内存 */
+        /* 初始化 Value 的内存：拷贝总是从库的默认内存资源分配，因此从 Document 中拷贝出来的值不依赖其内存池 */
         void Value::init(const Value &rhs) noexcept
         {
             type_ = rhs.type_;
@@ -31,38 +45,88 @@ namespace yfn
             {
             case json::Number: num_ = rhs.num_;
                 break;
-            case json::String: new(&str_) std::string(rhs.str_);
+            case json::String: new(&str_) string_type(rhs.str_, default_resource());
+                break;
+            case json::Array: new(&arr_) array_type(rhs.arr_, default_resource());
+                break;
+            case json::Object: new(&obj_) Object{ object_type(rhs.obj_.members, default_resource()) };
+                index_rebuild();
+                break;
+            }
+        }
+
+        /* 通过移动初始化 Value：只转移 union 中的成员，不拷贝子树，之后 rhs 置为 null */
+        void Value::init(Value &&rhs) noexcept
+        {
+            type_ = rhs.type_;
+            num_ = 0;
+            switch (type_)
+            {
+            case json::Number: num_ = rhs.num_;
+                break;
+            case json::String: new(&str_) string_type(std::move(rhs.str_));
                 break;
-            case json::Array: new(&arr_) std::vector<Value>(rhs.arr_);
+            case json::Array: new(&arr_) array_type(std::move(rhs.arr_));
                 break;
-            case json::Object: new(&obj_) std::vector<std::pair<std::string, Value>> (rhs.obj_);
+            case json::Object:
+                new(&obj_) Object{ object_type(std::move(rhs.obj_.members)), rhs.obj_.index };
+                rhs.obj_.index = nullptr;
+                break;
+            default:
                 break;
             }
+            rhs.free();
+            rhs.type_ = json::Null;
         }
 
         /* 释放 Value 的内存 */
         void Value::free() noexcept
         {
-            using std::string;
             switch (type_)
             {
-            case json::String: str_.~string(); // 显示调用相应的析构函数
+            case json::String: str_.~string_type(); // 显示调用相应的析构函数
                 break;
-            case json::Array: arr_.~vector<Value>();
+            case json::Array: arr_.~array_type();
                 break;
-            case json::Object: obj_.~vector<std::pair<std::string, Value>>();
+            case json::Object:
+                index_free();
+                obj_.~Object();
                 break;
             }
         }
 
         /* 解析 json 字符串 */
-        void Value::parse(const std::string &content){
-            Parser(*this, content);
+        void Value::parse(const char *data, size_t len, const ParseOptions &options){
+            ParseResult result = try_parse(data, len, options);
+            if (!result)
+                throw(Exception(result.code, result.offset));
+        }
+
+        /* 不抛出异常的解析：返回错误码与出错位置的字节偏移 */
+        ParseResult Value::try_parse(const char *data, size_t len, const ParseOptions &options) noexcept{
+            return Parser(*this, data, len, options, default_resource()).parse();
+        }
+
+        /* 指定内存资源的解析：所有字符串、数组与对象都从 resource 中分配 */
+        ParseResult Value::try_parse(const char *data, size_t len, const ParseOptions &options, std::pmr::memory_resource *resource) noexcept{
+            return Parser(*this, data, len, options, resource).parse();
         }
 
         /* 序列化 json 字符串 */
-        void Value::stringify(std::string &content) const noexcept{
-            Generator(*this, content);
+        void Value::stringify(std::string &content, const StringifyOptions &options) const noexcept{
+            if (options.exact_size)
+                Generator(*this, content, Generator::serialized_size(*this));
+            else
+                Generator(*this, content);
+        }
+
+        size_t Value::serialized_size() const noexcept{
+            return Generator::serialized_size(*this);
+        }
+
+        /* 通过固定大小的缓冲区序列化到 sink */
+        bool Value::stringify(Sink &sink, size_t buffer_size) const{
+            return Generator(*this, sink, buffer_size).ok();
         }
 
         /* 对 null、false、true 操作 */
@@ -94,20 +158,31 @@ namespace yfn
 
         /* 对字符串操作 */
         /* 获得 Value 中解析出来的字符串 */
-        const std::string& Value::get_string() const noexcept{
+        std::string_view Value::get_string() const noexcept{
             assert(type_ == type::String);
             return str_;
         }
 
         /* 设置 Value 中的字符串 */
-        void Value::set_string(const std::string &str) noexcept{
+        void Value::set_string(std::string_view str) noexcept{
             if(type_ == json::String)
-                str_ = str;
+                str_.assign(str.data(), str.size());
             else{
                 // 释放内存，然后重新设置字符串
                 free();
                 type_ = json::String;
-                new(&str_) std::string(str);
+                new(&str_) string_type(str, default_resource());
+            }
+        }
+
+        /* 通过移动设置 Value 中的字符串 */
+        void Value::set_string(string_type &&str) noexcept{
+            if(type_ == json::String)
+                str_ = std::move(str);
+            else{
+                free();
+                type_ = json::String;
+                new(&str_) string_type(std::move(str));
             }
         }
 
@@ -124,14 +199,36 @@ namespace yfn
             return arr_[index];
         }
 
+        Value& Value::get_array_element(size_t index) noexcept{
+            assert(type_ == json::Array);
+            return arr_[index];
+        }
+
+        /* 数组元素所在的连续内存，供迭代器使用 */
+        const Value* Value::array_data() const noexcept{
+            assert(type_ == json::Array);
+            return arr_.data();
+        }
+
         /* 重置数组 */
-        void Value::set_array(const std::vector<Value> &arr) noexcept{
+        void Value::set_array(const array_type &arr) noexcept{
             if(type_ == json::Array)
                 arr_ = arr;
             else {
                 free();
                 type_ = json::Array;
-                new(&arr_) std::vector<Value>(arr);
+                new(&arr_) array_type(arr, default_resource());
+            }
+        }
+
+        /* 通过移动重置数组 */
+        void Value::set_array(array_type &&arr) noexcept{
+            if(type_ == json::Array)
+                arr_ = std::move(arr);
+            else {
+                free();
+                type_ = json::Array;
+                new(&arr_) array_type(std::move(arr));
             }
         }
 
@@ -140,6 +237,18 @@ namespace yfn
             assert(type_ == json::Array);
             arr_.push_back(val);
         }
+
+        /* 在数组末尾移入元素 */
+        void Value::pushback_array_element(Value &&val) noexcept{
+            assert(type_ == json::Array);
+            arr_.push_back(std::move(val));
+        }
+
+        /* 在数组末尾原地构造一个 null 元素并返回其引用，供解析器直接在父容器中构建子节点 */
+        Value& Value::emplace_array_element() noexcept{
+            assert(type_ == json::Array);
+            return arr_.emplace_back();
+        }
         
         /* 删除数组的最后一个元素 */
         void Value::popback_array_element() noexcept{
@@ -169,52 +278,100 @@ namespace yfn
         /* 获得对象的大小 */
         size_t Value::get_object_size() const noexcept{
             assert(type_ == json::Object);
-            return obj_.size();
+            return obj_.members.size();
         }
 
         /* 根据索引获得对象的 key 值 */
-        const std::string& Value::get_object_key(size_t index) const noexcept{
+        std::string_view Value::get_object_key(size_t index) const noexcept{
             assert(type_ == json::Object);
-            return obj_[index].first;
+            return obj_.members[index].first;
         }
 
         /* 根据索引获得该 key 值的长度 */
         size_t Value::get_object_key_length(size_t index) const noexcept{
             assert(type_ == json::Object);
-            return obj_[index].first.size();
+            return obj_.members[index].first.size();
         }
 
         /* 根据索引获得对象的 value 值 */
         const Value& Value::get_object_value(size_t index) const noexcept{
             assert(type_ == json::Object);
-            return obj_[index].second;
+            return obj_.members[index].second;
+        }
+
+        Value& Value::get_object_value(size_t index) noexcept{
+            assert(type_ == json::Object);
+            return obj_.members[index].second;
+        }
+
+        /* 键值对所在的连续内存，供迭代器使用 */
+        const Value::member_type* Value::object_data() const noexcept{
+            assert(type_ == json::Object);
+            return obj_.members.data();
         }
 
         /* 根据 key 值设置该对象的 value 值 */
-        void Value::set_object_value(const std::string &key, const Value &val) noexcept{
+        void Value::set_object_value(std::string_view key, const Value &val) noexcept{
             assert(type_ == json::Object);
             // 若 key 值存在，则替换 key 值对应的 value；否则就添加新的一个键值对
             auto index = find_object_index(key);
-            if(index >= 0)obj_[index].second = val;
-            else obj_.push_back(make_pair(key, val));
+            if(index >= 0)obj_.members[index].second = val;
+            else {
+                obj_.members.emplace_back(key, val);
+                index_insert(obj_.members.size() - 1);
+            }
+        }
+
+        /* 根据 key 值移入该对象的 value 值 */
+        void Value::set_object_value(std::string_view key, Value &&val) noexcept{
+            assert(type_ == json::Object);
+            auto index = find_object_index(key);
+            if(index >= 0)obj_.members[index].second = std::move(val);
+            else {
+                obj_.members.emplace_back(key, std::move(val));
+                index_insert(obj_.members.size() - 1);
+            }
+        }
+
+        /* 在对象末尾原地构造一个 value 为 null 的键值对并返回 value 的引用（不检查 key 是否重复） */
+        Value& Value::emplace_object_value(string_type &&key) noexcept{
+            assert(type_ == json::Object);
+            obj_.members.emplace_back(std::move(key), Value());
+            index_insert(obj_.members.size() - 1);
+            return obj_.members.back().second;
         }
 
         /* 重置对象 */
-        void Value::set_object(const std::vector<std::pair<std::string, Value>> &obj) noexcept{
+        void Value::set_object(const object_type &obj) noexcept{
+            if(type_ == json::Object)
+                obj_.members = obj;
+            else {
+                free();
+                type_ = json::Object;
+                new(&obj_) Object{ object_type(obj, default_resource()) };
+            }
+            index_rebuild();
+        }
+
+        /* 通过移动重置对象 */
+        void Value::set_object(object_type &&obj) noexcept{
             if(type_ == json::Object)
-                obj_ = obj;
+                obj_.members = std::move(obj);
             else {
                 free();
                 type_ = json::Object;
-                new(&obj_) std::vector<std::pair<std::string, Value>>(obj);
+                new(&obj_) Object{ object_type(std::move(obj)) };
             }
+            index_rebuild();
         }
 
-        /* 根据 key 值寻找该对象在数组中的索引号 */
-        long long Value::find_object_index(const std::string &key) const noexcept{
+        /* 根据 key 值寻找该对象在数组中的索引号：有哈希索引时为 O(1)，否则线性查找 */
+        long long Value::find_object_index(std::string_view key) const noexcept{
             assert(type_ == json::Object);
-            for(size_t i = 0, n = obj_.size(); i < n; ++i){
-                if(obj_[i].first == key)
+            if(obj_.index != nullptr)
+                return index_find(key);
+            for(size_t i = 0, n = obj_.members.size(); i < n; ++i){
+                if(obj_.members[i].first == key)
                     return i;
             }
             return -1;
@@ -223,13 +380,158 @@ namespace yfn
         /* 根据索引删除某个对象 */
         void Value::remove_object_value(size_t index) noexcept{
             assert(type_ == json::Object);
-            obj_.erase(obj_.begin()+index, obj_.begin()+index+1);
+            index_erase(index);
+            obj_.members.erase(obj_.members.begin()+index, obj_.members.begin()+index+1);
         }
 
         /* 清空对象 */
         void Value::clear_object() noexcept{
             assert(type_ == json::Object);
-            obj_.clear();
+            index_free();
+            obj_.members.clear();
+        }
+
+        /*
+            对象的哈希索引：开放寻址（线性探测）的散列表，槽中保存成员下标 + 1，0 表示空槽。
+            表的容量为 2 的幂且至少是成员个数的两倍；只保存下标而不保存 key，members 扩容时索引不会失效。
+        */
+        struct Value::ObjectIndex
+        {
+            explicit ObjectIndex(std::pmr::memory_resource *resource) : slots(resource) { }
+            std::pmr::vector<uint32_t> slots;
+        };
+
+        /* 统计占用的堆内存：字符串只有超出短字符串优化的容量时才占用堆内存 */
+        size_t Value::memory_usage() const noexcept{
+            static const size_t sso_capacity = string_type().capacity();
+            auto string_usage = [](const string_type &s) -> size_t {
+                return s.capacity() > sso_capacity ? s.capacity() + 1 : 0;
+            };
+            size_t bytes = 0;
+            switch (type_)
+            {
+            case json::String:
+                bytes = string_usage(str_);
+                break;
+            case json::Array:
+                bytes = arr_.capacity() * sizeof(Value);
+                for (const Value &e : arr_)
+                    bytes += e.memory_usage();
+                break;
+            case json::Object:
+                bytes = obj_.members.capacity() * sizeof(member_type);
+                for (const member_type &m : obj_.members)
+                    bytes += string_usage(m.first) + m.second.memory_usage();
+                if (obj_.index != nullptr)
+                    bytes += sizeof(ObjectIndex) + obj_.index->slots.capacity() * sizeof(uint32_t);
+                break;
+            default:
+                break;
+            }
+            return bytes;
+        }
+
+        static inline size_t hash_key(std::string_view key) noexcept
+        {
+            return std::hash<std::string_view>{}(key);
+        }
+
+        /* 重新建立哈希索引：成员不多时直接释放索引 */
+        void Value::index_rebuild() noexcept{
+            const object_type &members = obj_.members;
+            if(members.size() <= kObjectIndexThreshold){
+                index_free();
+                return;
+            }
+            if(obj_.index == nullptr){
+                // 索引与 members 使用同一个内存资源，Document 丢弃内存池时索引也随之释放
+                std::pmr::memory_resource *resource = members.get_allocator().resource();
+                obj_.index = new(resource->allocate(sizeof(ObjectIndex), alignof(ObjectIndex))) ObjectIndex(resource);
+            }
+            size_t capacity = 32;
+            while(capacity < members.size() * 2)
+                capacity *= 2;
+            std::pmr::vector<uint32_t> &slots = obj_.index->slots;
+            slots.assign(capacity, 0);
+            size_t mask = capacity - 1;
+            for(size_t i = 0, n = members.size(); i < n; ++i){
+                size_t h = hash_key(members[i].first) & mask;
+                while(slots[h] != 0)
+                    h = (h + 1) & mask;
+                slots[h] = static_cast<uint32_t>(i + 1);
+            }
+        }
+
+        /* 成员 pos 加入 members 之后更新索引，装载因子超过 1/2 时扩容 */
+        void Value::index_insert(size_t pos) noexcept{
+            if(obj_.index == nullptr || obj_.members.size() * 2 > obj_.index->slots.size()){
+                if(obj_.members.size() > kObjectIndexThreshold)
+                    index_rebuild();
+                return;
+            }
+            std::pmr::vector<uint32_t> &slots = obj_.index->slots;
+            size_t mask = slots.size() - 1;
+            size_t h = hash_key(obj_.members[pos].first) & mask;
+            while(slots[h] != 0)
+                h = (h + 1) & mask;
+            slots[h] = static_cast<uint32_t>(pos + 1);
+        }
+
+        /* 成员 pos 从 members 中删除之前更新索引：删除对应的槽，并把之后成员的下标减一 */
+        void Value::index_erase(size_t pos) noexcept{
+            if(obj_.index == nullptr)
+                return;
+            if(obj_.members.size() - 1 <= kObjectIndexThreshold){
+                index_free();
+                return;
+            }
+            std::pmr::vector<uint32_t> &slots = obj_.index->slots;
+            size_t mask = slots.size() - 1;
+            size_t i = hash_key(obj_.members[pos].first) & mask;
+            while(slots[i] != pos + 1)
+                i = (i + 1) & mask;
+            // 线性探测的删除：把探测链上后面的元素往前移，保证其余的 key 仍然能被找到
+            for(size_t j = i;;){
+                slots[i] = 0;
+                for(;;){
+                    j = (j + 1) & mask;
+                    if(slots[j] == 0)
+                        goto shifted;
+                    size_t k = hash_key(obj_.members[slots[j] - 1].first) & mask;
+                    // k 循环地落在 (i, j] 之间时，该元素不能移到 i
+                    if(i <= j ? (i < k && k <= j) : (i < k || k <= j))
+                        continue;
+                    slots[i] = slots[j];
+                    i = j;
+                    break;
+                }
+            }
+        shifted:
+            for(uint32_t &slot : slots){
+                if(slot > pos + 1)
+                    --slot;
+            }
+        }
+
+        /* 释放哈希索引 */
+        void Value::index_free() noexcept{
+            if(obj_.index == nullptr)
+                return;
+            std::pmr::memory_resource *resource = obj_.members.get_allocator().resource();
+            obj_.index->~ObjectIndex();
+            resource->deallocate(obj_.index, sizeof(ObjectIndex), alignof(ObjectIndex));
+            obj_.index = nullptr;
+        }
+
+        /* 通过哈希索引查找 key */
+        long long Value::index_find(std::string_view key) const noexcept{
+            const std::pmr::vector<uint32_t> &slots = obj_.index->slots;
+            size_t mask = slots.size() - 1;
+            for(size_t h = hash_key(key) & mask; slots[h] != 0; h = (h + 1) & mask){
+                if(obj_.members[slots[h] - 1].first == key)
+                    return slots[h] - 1;
+            }
+            return -1;
         }
 
         /* 比较两个 json 值 */
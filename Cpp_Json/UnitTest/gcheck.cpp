@@ -1,6 +1,23 @@
 #include <gtest/gtest.h>
 #include "../Source/include/json.h"
+#include "../Source/include/jsonException.h"
+#include "../Source/include/jsonDocument.h"
+#include "../Source/include/jsonSink.h"
+#include "../Source/include/jsonHandler.h"
+#include "../Source/include/jsonPushParser.h"
+#include "../Source/include/jsonLines.h"
 #include <string>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <new>
+#include <sstream>
+#include <thread>
+#include <vector>
 
 using namespace std;
 using namespace yfn;
@@ -55,6 +72,29 @@ TEST(TestNumber,Number)
 	test_number(0.0, "1e-10000"); /* must underflow */
 }
 
+TEST(TestNumber,Boundary)
+{
+	test_number(1.0000000000000002, "1.0000000000000002"); /* the smallest number > 1 */
+	test_number( 4.9406564584124654e-324, "4.9406564584124654e-324"); /* minimum denormal */
+	test_number(-4.9406564584124654e-324, "-4.9406564584124654e-324");
+	test_number( 2.2250738585072009e-308, "2.2250738585072009e-308");  /* Max subnormal double */
+	test_number(-2.2250738585072009e-308, "-2.2250738585072009e-308");
+	test_number( 2.2250738585072014e-308, "2.2250738585072014e-308");  /* Min normal positive double */
+	test_number(-2.2250738585072014e-308, "-2.2250738585072014e-308");
+	test_number( 1.7976931348623157e+308, "1.7976931348623157e+308");  /* Max double */
+	test_number(-1.7976931348623157e+308, "-1.7976931348623157e+308");
+	test_number(9007199254740992.0, "9007199254740993"); /* 2^53 + 1 rounds to even */
+	test_number(1e23, "1e23");
+	test_number(0.1, "0.1");
+	test_number(123.456, "0.000000000000000000000000000000123456e33");
+	/* more than 19 significant digits */
+	test_number(1.0, "1.00000000000000011102230246251565404236316680908203125"); /* halfway rounds to even */
+	test_number(1.0000000000000002, "1.00000000000000011102230246251565404236316680908203126");
+	test_number(1.0, "1.00000000000000011102230246251565404236316680908203124");
+	test_number(1.2345678901234568e29, "123456789012345678901234567890");
+	test_number(0.0, "0.000000000000000000000000000000000000000000000e999999999999");
+}
+
 #define test_string(expect, content)\
     do {\
         yfn::Json j;\
@@ -80,6 +120,32 @@ TEST(TestString, String)
 	test_string("\xF0\x9D\x84\x9E", "\"\\ud834\\udd1e\"");  /* G clef sign U+1D11E */
 }
 
+// 测试长字符串：转义字符与控制字符出现在 SIMD 块内的各个位置
+TEST(TestLongString, LongString)
+{
+	for (size_t len = 0; len < 80; ++len) {
+		std::string plain(len, 'x');
+		test_string(plain.c_str(), ("\"" + plain + "\"").c_str());
+
+		for (size_t k = 0; k < len; ++k) {
+			std::string expect = plain, content = plain;
+			expect[k] = '\n';
+			content.replace(k, 1, "\\n");
+			test_string(expect.c_str(), ("\"" + content + "\"").c_str());
+
+			content = plain;
+			content[k] = '\x01';
+			yfn::Json j;
+			j.parse("\"" + content + "\"", status);
+			EXPECT_EQ("parse invalid string char", status);
+		}
+
+		yfn::Json j;
+		j.parse("\"" + plain, status);
+		EXPECT_EQ("parse miss quotation mark", status);
+	}
+}
+
 TEST(TestArray, Array)
 {
 	yfn::Json j;
@@ -171,6 +237,45 @@ TEST(TestObject, Object)
 	}
 }
 
+// 测试解析深层嵌套的数组与对象
+TEST(TestParseNested, ParseNested)
+{
+	std::string content;
+	const int depth = 500;
+	for (int i = 0; i < depth; ++i)
+		content += "{\"a\":[";
+	content += "\"leaf\"";
+	for (int i = 0; i < depth; ++i)
+		content += "]}";
+
+	yfn::Json v;
+	v.parse(content, status);
+	EXPECT_EQ("parse ok", status);
+	v.stringify(status);
+	EXPECT_EQ(content, status);
+}
+
+// 测试嵌套深度限制：超过 max_depth 时解析失败，而不是栈溢出
+TEST(TestParseDepth, ParseDepth)
+{
+	json::ParseOptions options;
+	options.max_depth = 3;
+	yfn::Json v;
+	v.parse("[[{}]]", status, options);
+	EXPECT_EQ("parse ok", status);
+	v.parse("[[{\"a\":[]}]]", status, options);
+	EXPECT_EQ("parse depth exceeded", status);
+	EXPECT_EQ(json::Null, v.get_type());
+
+	// 默认的深度限制下，恶意构造的极深嵌套也只会得到错误信息
+	std::string content(100000, '[');
+	v.parse(content, status);
+	EXPECT_EQ("parse depth exceeded", status);
+	content = std::string(1024, '[') + std::string(1024, ']');
+	v.parse(content, status);
+	EXPECT_EQ("parse ok", status);
+}
+
 #define test_error(error, content)\
 	do {\
 		yfn::Json v;\
@@ -180,6 +285,91 @@ TEST(TestObject, Object)
 	} while(0)
 
 
+#define test_error_offset(expect_code, expect_offset, content)\
+	do {\
+		yfn::Json v;\
+		v.set_boolean(true);\
+		json::ParseResult r = v.try_parse(content);\
+		EXPECT_FALSE(r);\
+		EXPECT_EQ(expect_code, r.code);\
+		EXPECT_EQ(expect_offset, r.offset);\
+		EXPECT_EQ((json::Null), v.get_type());\
+	} while(0)
+
+// 测试不抛出异常的解析接口返回的错误码与字节偏移
+TEST(TestParseResult, ParseResult)
+{
+	yfn::Json v;
+	json::ParseResult r = v.try_parse(" [1, 2] ");
+	EXPECT_TRUE(r);
+	EXPECT_EQ(json::ParseOk, r.code);
+	EXPECT_EQ(8, r.offset);
+	EXPECT_EQ(json::Array, v.get_type());
+
+	test_error_offset(json::ParseExpectValue, 2, "  ");
+	test_error_offset(json::ParseInvalidValue, 1, "[nul]");
+	test_error_offset(json::ParseRootNotSingular, 5, "null x");
+	test_error_offset(json::ParseNumberTooBig, 3, "[1,1e309]");
+	test_error_offset(json::ParseMissQuotationMark, 4, "\"abc");
+	test_error_offset(json::ParseInvalidStringEscape, 3, "\"ab\\v\"");
+	test_error_offset(json::ParseInvalidStringChar, 2, "\"a\x01\"");
+	test_error_offset(json::ParseInvalidUnicodeHex, 1, "\"\\u012\"");
+	test_error_offset(json::ParseInvalidUnicodeSurrogate, 1, "\"\\uD800\"");
+	test_error_offset(json::ParseMissCommaOrSquareBracket, 3, "[1 2]");
+	test_error_offset(json::ParseMissKey, 1, "{1:1}");
+	test_error_offset(json::ParseMissColon, 5, "{\"a\" 1}");
+	test_error_offset(json::ParseMissCommaOrCurlyBracket, 6, "{\"a\":1]");
+
+	json::ParseOptions options;
+	options.max_depth = 2;
+	r = v.try_parse("[[[]]]", options);
+	EXPECT_EQ(json::ParseDepthExceeded, r.code);
+	EXPECT_EQ(2, r.offset);
+	EXPECT_STREQ("parse depth exceeded", json::error_message(r.code));
+}
+
+// 测试抛出异常的解析接口
+TEST(TestParseException, ParseException)
+{
+	yfn::Json v;
+	EXPECT_NO_THROW(v.parse("[1,2,3]"));
+	try {
+		v.parse("[1,2,]");
+		ADD_FAILURE();
+	} catch (const json::Exception &e) {
+		EXPECT_STREQ("parse invalid value", e.what());
+		EXPECT_EQ(json::ParseInvalidValue, e.code());
+		EXPECT_EQ(5, e.offset());
+	}
+	EXPECT_EQ(json::Null, v.get_type());
+}
+
+// 测试按指针与长度解析：输入不以 '\0' 结尾，也不会读取长度之外的字节
+TEST(TestParseBuffer, ParseBuffer)
+{
+	yfn::Json v;
+	const char buffer[] = "[1,\"abc\",{\"k\":true}]trailing";
+	EXPECT_EQ(json::ParseOk, v.try_parse(buffer, 20).code);
+	EXPECT_EQ(json::Array, v.get_type());
+	EXPECT_EQ(3, v.get_array_size());
+	EXPECT_EQ(json::ParseRootNotSingular, v.try_parse(buffer, 21).code);
+	EXPECT_EQ(json::ParseOk, v.try_parse(std::string_view(buffer + 1, 1)).code);
+	EXPECT_EQ(1.0, v.get_number());
+
+	// 截断在每一个位置的输入都只会得到错误码
+	const std::string content = "{\"a\":[null,true,false,-1.5e3,\"x\\u00e9\\uD834\\uDD1E\"]}";
+	for (size_t len = 0; len < content.size(); ++len) {
+		std::unique_ptr<char[]> copy(new char[len + 1]);
+		memcpy(copy.get(), content.data(), len);
+		EXPECT_NE(json::ParseOk, v.try_parse(copy.get(), len).code);
+	}
+	EXPECT_EQ(json::ParseOk, v.try_parse(content).code);
+
+	// 输入中间的 '\0' 不再被当作结尾
+	EXPECT_EQ(json::ParseRootNotSingular, v.try_parse(std::string_view("null\0", 5)).code);
+	EXPECT_EQ(json::ParseInvalidStringChar, v.try_parse(std::string_view("\"a\0\"", 4)).code);
+}
+
 // 测试解析期望值
 TEST(TestParseExpectValue, ParseExpectValue)
 {
@@ -340,16 +530,41 @@ TEST(TestStringifyNumber, StringifyNumber)
 	test_roundtrip("1.234e-20");
 
 	test_roundtrip("1.0000000000000002"); /* the smallest number > 1 */
-	test_roundtrip("4.9406564584124654e-324"); /* minimum denormal */
-	test_roundtrip("-4.9406564584124654e-324");
-	test_roundtrip("2.2250738585072009e-308");  /* Max subnormal double */
-	test_roundtrip("-2.2250738585072009e-308");
+	test_roundtrip("5e-324"); /* minimum denormal */
+	test_roundtrip("-5e-324");
+	test_roundtrip("2.225073858507201e-308");  /* Max subnormal double */
+	test_roundtrip("-2.225073858507201e-308");
 	test_roundtrip("2.2250738585072014e-308");  /* Min normal positive double */
 	test_roundtrip("-2.2250738585072014e-308");
 	test_roundtrip("1.7976931348623157e+308");  /* Max double */
 	test_roundtrip("-1.7976931348623157e+308");
 }
 
+// 序列化为最短的往返表示：先解析 content，再比较生成的字符串与 expect
+#define test_stringify(expect, content)\
+	do {\
+		yfn::Json v;\
+		v.parse(content, status);\
+		EXPECT_EQ("parse ok", status);\
+		v.stringify(status);\
+		EXPECT_EQ(expect, status);\
+	} while(0)
+
+// 测试序列化数字的最短表示
+TEST(TestStringifyNumber, StringifyShortest)
+{
+	test_stringify("0.1", "0.10000000000000001");
+	test_stringify("0.3", "0.29999999999999999");
+	test_stringify("1e+23", "1e23");
+	test_stringify("1e-05", "0.00001");
+	test_stringify("0.0001", "1e-4");
+	test_stringify("10000000000000000", "1e16");
+	test_stringify("1.2345678901234568e+17", "123456789012345678");
+	test_stringify("9007199254740992", "9007199254740993");
+	test_stringify("-0", "-0.0");
+	test_stringify("5e-324", "4.9406564584124654e-324");
+}
+
 // 测试序列化字符串
 TEST(TestStringifyString, StringifyString)
 {
@@ -440,6 +655,43 @@ TEST(TestMove, Move)
 	EXPECT_EQ(1, int(v3 == v1));
 }
 
+// 测试移入数组元素与对象成员
+TEST(TestMoveElement, MoveElement)
+{
+	yfn::Json a, o, e;
+	a.set_array();
+	e.parse("{\"a\":[1,2,3],\"s\":\"abc\"}");
+	yfn::Json copy = e;
+	a.pushback_array_element(std::move(e));
+	EXPECT_EQ(json::Null, e.get_type());
+	EXPECT_EQ(1, a.get_array_size());
+	EXPECT_EQ(1, int(a.get_array_element(0) == copy));
+
+	o.set_object();
+	e = copy;
+	o.set_object_value("k", std::move(e));
+	EXPECT_EQ(json::Null, e.get_type());
+	EXPECT_EQ(1, int(o.get_object_value(0) == copy));
+
+	std::string str = "Hello";
+	e.set_string(std::move(str));
+	EXPECT_EQ("Hello", e.get_string());
+
+	// 从库的默认内存资源分配的 pmr 字符串直接接管缓冲区，来自其他内存资源的则拷贝
+	std::pmr::string moved(100, 'm', json::default_resource());
+	const char *buffer = moved.data();
+	e.set_string(std::move(moved));
+	EXPECT_EQ(buffer, e.view().get_string().data());
+	{
+		std::pmr::monotonic_buffer_resource pool;
+		std::pmr::string copied(100, 'c', &pool);
+		buffer = copied.data();
+		e.set_string(std::move(copied));
+		EXPECT_NE(buffer, e.view().get_string().data());
+	}
+	EXPECT_EQ(std::string(100, 'c'), e.get_string());
+}
+
 // 测试是否交换
 TEST(TestSwap, Swap)
 {
@@ -603,4 +855,1081 @@ TEST(TestAccessObject, AccessObject)
 
 	o.clear_object();
 	EXPECT_EQ(0, o.get_object_size());
-}
\ No newline at end of file
+}
+// 测试 Document：所有节点从内存池中分配，reset 之后可以重复使用
+TEST(TestDocument, Document)
+{
+	yfn::Document doc(256);
+	std::string content = "{\"n\":null,\"s\":\"a string long enough to defeat sso\",\"a\":[1,2,[3,\"x\"]],\"o\":{\"k\":true}}";
+	EXPECT_EQ(json::ParseOk, doc.parse(content).code);
+	const json::Value &root = doc.root();
+	EXPECT_EQ(json::Object, root.get_type());
+	EXPECT_EQ(4, root.get_object_size());
+	EXPECT_EQ("s", root.get_object_key(1));
+	EXPECT_EQ("a string long enough to defeat sso", root.get_object_value(1).get_string());
+	EXPECT_EQ(3, root.get_object_value(2).get_array_size());
+
+	std::string out;
+	doc.stringify(out);
+	EXPECT_EQ(content, out);
+
+	// to_json 拷贝出来的值不依赖内存池
+	yfn::Json copy = doc.to_json();
+	doc.reset();
+	EXPECT_EQ(json::Null, doc.root().get_type());
+	copy.stringify(out);
+	EXPECT_EQ(content, out);
+
+	// 预热之后，反复解析同样大小的文本不再申请新的内存块
+	EXPECT_EQ(json::ParseOk, doc.parse(content).code);
+	size_t capacity = doc.arena_capacity();
+	for (int i = 0; i < 100; ++i)
+		EXPECT_EQ(json::ParseOk, doc.parse(content).code);
+	EXPECT_EQ(capacity, doc.arena_capacity());
+
+	// 解析失败时根节点为 null，之后仍然可以继续解析
+	json::ParseResult result = doc.parse("[1,2,");
+	EXPECT_EQ(json::ParseExpectValue, result.code);
+	EXPECT_EQ(json::Null, doc.root().get_type());
+	EXPECT_EQ(json::ParseOk, doc.parse("[\"ok\"]").code);
+	EXPECT_EQ("ok", doc.root().get_array_element(0).get_string());
+}
+
+// 测试成员较多的对象：超过阈值后通过哈希索引查找，插入、删除之后索引与成员保持同步，并保留插入顺序
+TEST(TestLargeObject, LargeObject)
+{
+	yfn::Json o, v;
+	o.set_object();
+	const int n = 1000;
+	for (int i = 0; i < n; ++i) {
+		v.set_number(i);
+		o.set_object_value("key" + std::to_string(i), v);
+	}
+	EXPECT_EQ(n, o.get_object_size());
+	for (int i = 0; i < n; ++i) {
+		EXPECT_EQ("key" + std::to_string(i), o.get_object_key(i));
+		EXPECT_EQ(i, o.find_object_index("key" + std::to_string(i)));
+	}
+	EXPECT_EQ(-1, o.find_object_index("missing"));
+
+	// 覆盖已有的 key 不会新增成员
+	v.set_string("replaced");
+	o.set_object_value("key500", v);
+	EXPECT_EQ(n, o.get_object_size());
+	EXPECT_EQ("replaced", o.get_object_value(500).get_string());
+
+	// 删除之后，后面成员的下标减一
+	for (int i = 0; i < n; i += 3)
+		o.remove_object_value(o.find_object_index("key" + std::to_string(i)));
+	for (int i = 0; i < n; ++i) {
+		auto index = o.find_object_index("key" + std::to_string(i));
+		if (i % 3 == 0)
+			EXPECT_EQ(-1, index);
+		else {
+			ASSERT_GE(index, 0);
+			EXPECT_EQ("key" + std::to_string(i), o.get_object_key(index));
+		}
+	}
+
+	// 拷贝、比较、序列化后重新解析
+	yfn::Json copy = o;
+	EXPECT_EQ(1, int(copy == o));
+	std::string out;
+	o.stringify(out);
+	yfn::Json parsed;
+	parsed.parse(out);
+	EXPECT_EQ(1, int(parsed == o));
+	EXPECT_EQ(o.find_object_index("key998"), parsed.find_object_index("key998"));
+
+	// 删除到阈值以下之后仍然可以正常查找
+	while (o.get_object_size() > 3)
+		o.remove_object_value(0);
+	EXPECT_EQ(0, o.find_object_index("key995"));
+	EXPECT_EQ(2, o.find_object_index("key998"));
+	o.clear_object();
+	EXPECT_EQ(-1, o.find_object_index("key998"));
+}
+
+// 测试 JsonView 与 JsonRef：直接指向树中的节点，不拷贝子树
+TEST(TestJsonView, JsonView)
+{
+	yfn::Json j;
+	j.parse("{\"a\":[1,\"str\",{\"k\":true}],\"s\":\"hello\",\"n\":null}");
+	yfn::JsonView v = j.view();
+	EXPECT_EQ(json::Object, v.get_type());
+	EXPECT_EQ(3, v.get_object_size());
+	EXPECT_EQ("a", v.get_object_key(0));
+
+	yfn::JsonView a = v.get_object_value(v.find_object_index("a"));
+	EXPECT_EQ(3, a.get_array_size());
+	EXPECT_EQ(1.0, a.get_array_element(0).get_number());
+	EXPECT_EQ("str", a.get_array_element(1).get_string());
+	EXPECT_EQ(json::True, a.get_array_element(2).get_object_value(0).get_type());
+
+	// 字符串直接指向树中的数据，两次访问得到同一块内存
+	std::string_view s = v.get_object_value(1).get_string();
+	EXPECT_EQ("hello", s);
+	EXPECT_EQ(s.data(), j.view().get_object_value(1).get_string().data());
+
+	// 与 Json 的比较以及深拷贝
+	EXPECT_EQ(1, int(a == j.get_object_value(0).view()));
+	EXPECT_EQ(1, int(a.to_json() == j.get_object_value(0)));
+	EXPECT_EQ(json::Null, yfn::JsonView().get_type());
+
+	// 通过 JsonRef 原地修改
+	yfn::JsonRef r = j.ref().get_object_value(0);
+	r.get_array_element(0).set_number(2.0);
+	r.get_array_element(1).set_string("changed");
+	yfn::Json e;
+	e.set_number(3.0);
+	r.pushback_array_element(std::move(e));
+	r.get_array_element(2).set_object_value("x", yfn::Json());
+	j.ref().set_object_value("s", yfn::Json());
+	std::string out;
+	j.stringify(out);
+	EXPECT_EQ("{\"a\":[2,\"changed\",{\"k\":true,\"x\":null},3],\"s\":null,\"n\":null}", out);
+
+	// Document 的只读视图
+	yfn::Document doc;
+	doc.parse(out);
+	EXPECT_EQ(1, int(doc.view() == j.view()));
+}
+
+// 测试迭代器：range-for 遍历数组与对象，数组迭代器可用于 <algorithm>
+TEST(TestIterator, Iterator)
+{
+	yfn::Json j;
+	j.parse("[3,1,4,1,5,9,2,6]");
+	double sum = 0;
+	for (yfn::JsonView e : j)
+		sum += e.get_number();
+	EXPECT_EQ(31.0, sum);
+
+	EXPECT_EQ(8, std::distance(j.begin(), j.end()));
+	EXPECT_EQ(4.0, j.begin()[2].get_number());
+	EXPECT_EQ(6.0, (*(j.end() - 1)).get_number());
+	EXPECT_EQ(2, std::count_if(j.begin(), j.end(), [](yfn::JsonView e) { return e.get_number() == 1.0; }));
+	auto it = std::find_if(j.begin(), j.end(), [](yfn::JsonView e) { return e.get_number() > 4.0; });
+	EXPECT_EQ(4, it - j.begin());
+	EXPECT_EQ(1, int(j.begin() < it && it < j.end()));
+
+	j.parse("{\"a\":1,\"b\":[true,false],\"c\":\"x\"}");
+	std::vector<std::string> keys;
+	for (auto m : j.members())
+		keys.emplace_back(m.key);
+	EXPECT_EQ((std::vector<std::string>{"a", "b", "c"}), keys);
+	yfn::JsonView b = j.view().get_object_value(1);
+	EXPECT_EQ(2, std::distance(b.begin(), b.end()));
+	EXPECT_EQ(json::True, (*b.begin()).get_type());
+
+	// 空数组、空对象以及不指向节点的视图都是空区间
+	j.parse("[]");
+	EXPECT_EQ(1, int(j.begin() == j.end()));
+	j.parse("{}");
+	EXPECT_EQ(1, int(j.members().begin() == j.members().end()));
+	yfn::JsonView none;
+	EXPECT_EQ(1, int(none.begin() == none.end()));
+}
+
+// 测试内存占用统计：容器的容量与超出短字符串优化的字符串都计入
+TEST(TestMemoryUsage, MemoryUsage)
+{
+	yfn::Json j;
+	j.set_null();
+	size_t base = j.memory_usage();
+	EXPECT_EQ(base, j.view().memory_usage());
+	j.set_string("short");
+	EXPECT_EQ(base, j.memory_usage());
+	j.set_string(std::string(100, 'x'));
+	EXPECT_LE(base + 101, j.memory_usage());
+
+	j.parse("[1,2,3]");
+	size_t array_usage = j.memory_usage();
+	EXPECT_LE(base * 4, array_usage);
+	yfn::Json e;
+	e.set_number(1);
+	for (int i = 0; i < 100; ++i)
+		j.pushback_array_element(e);
+	EXPECT_LE(base * 104, j.memory_usage());
+	// 删除元素不会归还容量
+	size_t grown = j.memory_usage();
+	j.clear_array();
+	EXPECT_EQ(grown, j.memory_usage());
+
+	// 成员超过阈值的对象还要加上哈希索引
+	std::string text = "{";
+	for (int i = 0; i < 40; ++i)
+		text += (i ? ",\"key" : "\"key") + std::to_string(i) + "\":" + std::to_string(i);
+	text += "}";
+	j.parse(text);
+	EXPECT_LT(base * 41, j.memory_usage());
+	yfn::JsonView none;
+	EXPECT_EQ(0u, none.memory_usage());
+}
+
+// 测试解析统计
+TEST(TestParseStats, ParseStats)
+{
+	json::ParseStats stats;
+	json::ParseOptions options;
+	options.stats = &stats;
+	yfn::Json j;
+	const char text[] = "{\"ab\":[1,true,null,\"xyz\"],\"c\":{\"d\":false,\"e\":\"\"}}";
+	EXPECT_EQ(json::ParseOk, j.try_parse(text, sizeof(text) - 1, options).code);
+	EXPECT_EQ(2u, stats.nodes[json::Object]);
+	EXPECT_EQ(1u, stats.nodes[json::Array]);
+	EXPECT_EQ(1u, stats.nodes[json::Number]);
+	EXPECT_EQ(1u, stats.nodes[json::True]);
+	EXPECT_EQ(1u, stats.nodes[json::False]);
+	EXPECT_EQ(1u, stats.nodes[json::Null]);
+	EXPECT_EQ(2u, stats.nodes[json::String]);
+	EXPECT_EQ(9u, stats.node_count());
+	EXPECT_EQ(2u, stats.max_depth);
+	EXPECT_EQ(3u, stats.string_bytes);
+	EXPECT_EQ(5u, stats.key_bytes);
+	EXPECT_LT(0u, stats.allocations);
+	EXPECT_LT(0u, stats.allocated_bytes);
+
+	EXPECT_EQ(json::ParseOk, j.try_parse("1", 1, options).code);
+	EXPECT_EQ(1u, stats.node_count());
+	EXPECT_EQ(0u, stats.max_depth);
+	EXPECT_EQ(0u, stats.allocations);
+
+	// 失败时只统计分配
+	EXPECT_EQ(json::ParseMissCommaOrSquareBracket, j.try_parse("[1 2]", 5, options).code);
+	EXPECT_EQ(0u, stats.node_count());
+
+	// 预热之后 Document 的分配都来自内存池，次数与堆上的解析相同
+	yfn::Document doc;
+	doc.parse(text, options);
+	size_t allocations = stats.allocations;
+	EXPECT_EQ(json::ParseOk, doc.parse(text, options).code);
+	EXPECT_EQ(9u, stats.node_count());
+	EXPECT_EQ(allocations, stats.allocations);
+}
+
+// 测试全局分配钩子：分配与释放的字节数相抵
+static long long hook_balance = 0;
+static size_t hook_calls = 0;
+static void count_hook(size_t bytes, bool allocate)
+{
+	++hook_calls;
+	hook_balance += allocate ? (long long)bytes : -(long long)bytes;
+}
+
+TEST(TestAllocationHook, AllocationHook)
+{
+	json::set_allocation_hook(count_hook);
+	{
+		yfn::Json j;
+		j.parse("{\"a\":[1,2,3,\"a string longer than the small buffer\"],\"b\":{}}");
+		yfn::Json copy = j;
+		copy.set_object_value("c", j);
+		yfn::Document doc(256);
+		doc.parse("[\"a string longer than the small buffer\",{\"k\":[]}]");
+	}
+	EXPECT_LT(0u, hook_calls);
+	EXPECT_EQ(0, hook_balance);
+
+	// 生成时报告输出字符串的扩容；最后的缓冲区属于调用者，由调用者释放
+	{
+		yfn::Json j;
+		j.parse("[\"a string longer than the small buffer\",\"and another one of them\"]");
+		std::string out;
+		hook_balance = 0;
+		j.stringify(out);
+		EXPECT_EQ((long long)out.capacity() + 1, hook_balance);
+	}
+	json::set_allocation_hook(nullptr);
+
+	size_t calls = hook_calls;
+	yfn::Json j;
+	j.parse("[1,2,3]");
+	EXPECT_EQ(calls, hook_calls);
+}
+
+// 测试流式生成：各种 Sink 的输出都与生成到字符串的结果相同，缓冲区再小也不影响结果
+TEST(TestStringifySink, StringifySink)
+{
+	yfn::Json j;
+	std::string text = "[";
+	for (int i = 0; i < 200; ++i)
+		text += (i ? "," : "") + std::string("{\"id\":") + std::to_string(i) + ",\"text\":\"line\\n\\\"" + std::string(i % 50, 'x') + "\\u0001\"}";
+	text += "]";
+	j.parse(text);
+	std::string expect;
+	j.stringify(expect);
+
+	for (size_t buffer_size : { size_t(1), size_t(64), size_t(100), size_t(4096), json::kDefaultSinkBufferSize }) {
+		std::string out;
+		size_t max_chunk = 0;
+		json::CallbackSink sink([&](const char *data, size_t len) {
+			out.append(data, len);
+			max_chunk = std::max(max_chunk, len);
+			return true;
+		});
+		EXPECT_TRUE(j.stringify(sink, buffer_size));
+		EXPECT_EQ(expect, out);
+		EXPECT_GE(std::max(buffer_size, size_t(64)), max_chunk);
+	}
+
+	std::ostringstream os;
+	json::OStreamSink os_sink(os);
+	EXPECT_TRUE(j.view().stringify(os_sink, 128));
+	EXPECT_EQ(expect, os.str());
+
+	std::FILE *file = std::tmpfile();
+	ASSERT_NE(nullptr, file);
+	json::FileSink file_sink(file);
+	EXPECT_TRUE(j.ref().stringify(file_sink, 256));
+	json::FdSink fd_sink(fileno(file));
+	std::fflush(file);
+	yfn::Document doc;
+	doc.parse(text);
+	EXPECT_TRUE(doc.stringify(fd_sink));
+	std::string content(expect.size() * 2, '\0');
+	std::rewind(file);
+	EXPECT_EQ(content.size(), std::fread(&content[0], 1, content.size() + 1, file));
+	EXPECT_EQ(expect + expect, content);
+	std::fclose(file);
+
+	// sink 失败时停止生成
+	size_t calls = 0;
+	json::CallbackSink failing([&](const char *, size_t) { ++calls; return false; });
+	EXPECT_FALSE(j.stringify(failing, 64));
+	EXPECT_EQ(1u, calls);
+
+	yfn::JsonView none;
+	std::string null_out;
+	json::CallbackSink null_sink([&](const char *data, size_t len) { null_out.append(data, len); return true; });
+	EXPECT_TRUE(none.stringify(null_sink));
+	EXPECT_EQ("null", null_out);
+}
+
+// 测试字符串转义：需要转义的字节出现在 16/32 字节块的各个位置时，结果都与逐字节转义相同
+TEST(TestStringifyEscape, StringifyEscape)
+{
+	auto reference = [](const std::string &s) {
+		std::string out = "\"";
+		for (unsigned char ch : s) {
+			switch (ch) {
+			case '\"': out += "\\\""; break;
+			case '\\': out += "\\\\"; break;
+			case '\b': out += "\\b"; break;
+			case '\f': out += "\\f"; break;
+			case '\n': out += "\\n"; break;
+			case '\r': out += "\\r"; break;
+			case '\t': out += "\\t"; break;
+			default:
+				if (ch < 0x20) {
+					char buffer[7];
+					snprintf(buffer, sizeof(buffer), "\\u%04X", ch);
+					out += buffer;
+				}
+				else
+					out += char(ch);
+			}
+		}
+		return out + "\"";
+	};
+	yfn::Json j;
+	std::string out;
+	for (size_t len = 0; len <= 70; ++len) {
+		for (size_t pos = 0; pos < len; ++pos) {
+			for (unsigned char special : { '\"', '\\', '\x00', '\x1f', '\n', '\x7f', '\xe4' }) {
+				std::string s(len, 'a');
+				s[pos] = char(special);
+				j.set_string(s);
+				j.stringify(out);
+				EXPECT_EQ(reference(s), out);
+			}
+		}
+	}
+	std::string all;
+	for (int ch = 0; ch < 256; ++ch)
+		all += char(ch);
+	j.set_string(all);
+	j.stringify(out);
+	EXPECT_EQ(reference(all), out);
+}
+
+// 测试精确长度：serialized_size() 与 stringify 的输出长度一致，exact_size 模式的输出与普通模式相同
+TEST(TestSerializedSize, SerializedSize)
+{
+	const char *texts[] = {
+		"null", "true", "false", "0", "-1.5e-300", "1.7976931348623157e308", "\"\"",
+		"\"\\\" \\\\ / \\b \\f \\n \\r \\t \\u0001 \\u001F \\u00e4\"",
+		"[]", "{}", "[1]", "[[],{},[null,[true]]]",
+		"{\"a\":1,\"b\\n\":[false,\"x\"],\"c\":{\"d\":{}}}",
+	};
+	json::StringifyOptions exact;
+	exact.exact_size = true;
+	for (const char *text : texts) {
+		yfn::Json j;
+		j.parse(text);
+		std::string out, exact_out = "previous content";
+		j.stringify(out);
+		j.stringify(exact_out, exact);
+		EXPECT_EQ(out.size(), j.serialized_size());
+		EXPECT_EQ(out, exact_out);
+		EXPECT_EQ(out.size(), j.view().serialized_size());
+		EXPECT_EQ(out.size(), j.ref().serialized_size());
+	}
+
+	std::string text = "{";
+	for (int i = 0; i < 500; ++i)
+		text += (i ? ",\"k" : "\"k") + std::to_string(i) + "\":[" + std::to_string(i * 0.1) + ",\"\\t" + std::string(i, 'z') + "\"]";
+	text += "}";
+	yfn::Document doc;
+	doc.parse(text);
+	std::string out;
+	doc.stringify(out, exact);
+	EXPECT_EQ(out.size(), doc.serialized_size());
+	yfn::Json reparsed;
+	reparsed.parse(out);
+	EXPECT_EQ(1, int(doc.to_json() == reparsed));
+	yfn::JsonView none;
+	EXPECT_EQ(4u, none.serialized_size());
+}
+
+// 把事件记录为字符串的 Handler
+class EventRecorder : public json::Handler
+{
+public:
+	std::string events;
+	const char *input_begin = nullptr, *input_end = nullptr;
+	size_t views_into_input = 0;
+	size_t stop_after = size_t(-1);
+
+	bool on_null() override { return add("n"); }
+	bool on_bool(bool b) override { return add(b ? "t" : "f"); }
+	bool on_number(double d) override { return add("#" + std::to_string(int(d))); }
+	bool on_string(std::string_view s) override { check_view(s); return add("s:" + std::string(s)); }
+	bool on_key(std::string_view k) override { check_view(k); return add("k:" + std::string(k)); }
+	bool on_start_object() override { return add("{"); }
+	bool on_end_object(size_t n) override { return add("}" + std::to_string(n)); }
+	bool on_start_array() override { return add("["); }
+	bool on_end_array(size_t n) override { return add("]" + std::to_string(n)); }
+private:
+	bool add(const std::string &e)
+	{
+		events += events.empty() ? e : " " + e;
+		return --stop_after != 0;
+	}
+	void check_view(std::string_view s)
+	{
+		if (s.data() >= input_begin && s.data() + s.size() <= input_end)
+			++views_into_input;
+	}
+};
+
+// 测试 SAX 解析：事件顺序、不含转义的字符串直接指向输入、中途停止、错误码与 DOM 解析一致
+TEST(TestHandler, Handler)
+{
+	const std::string text = " {\"a\":[1,true,false,null,\"x\\ty\"],\"b\":{},\"c\":[],\"plain\":\"text\"} ";
+	EventRecorder r;
+	r.input_begin = text.data();
+	r.input_end = text.data() + text.size();
+	json::ParseResult result = json::parse(text, r);
+	EXPECT_EQ(json::ParseOk, result.code);
+	EXPECT_EQ(text.size(), result.offset);
+	EXPECT_EQ("{ k:a [ #1 t f n s:x\ty ]5 k:b { }0 k:c [ ]0 k:plain s:text }4", r.events);
+	// 除了含转义的 "x\ty" 以外，key 与字符串都直接指向输入
+	EXPECT_EQ(5u, r.views_into_input);
+
+	EventRecorder stop;
+	stop.stop_after = 3;
+	result = json::parse(text, stop);
+	EXPECT_EQ(json::ParseCancelled, result.code);
+	EXPECT_EQ("{ k:a [", stop.events);
+	EXPECT_STREQ("parse cancelled", json::error_message(result.code));
+
+	const char *invalid[] = { "", "[1,]", "{\"a\" 1}", "{1:1}", "[\"\\x\"]", "[1 2", "nul", "1 2", "\"\\uD800\"" };
+	for (const char *bad : invalid) {
+		json::Handler ignore;
+		yfn::Json j;
+		json::ParseResult sax = json::parse(bad, ignore);
+		json::ParseResult dom = j.try_parse(bad);
+		EXPECT_EQ(dom.code, sax.code) << bad;
+		EXPECT_EQ(dom.offset, sax.offset) << bad;
+	}
+
+	json::ParseStats stats;
+	json::ParseOptions options;
+	options.stats = &stats;
+	json::Handler ignore;
+	EXPECT_EQ(json::ParseOk, json::parse(text, ignore, options).code);
+	EXPECT_EQ(10u, stats.node_count());
+	EXPECT_EQ(2u, stats.max_depth);
+	EXPECT_EQ(8u, stats.key_bytes);
+	EXPECT_EQ(7u, stats.string_bytes);
+}
+
+// 测试增量解析：把文本切成各种大小的块，错误码、偏移以及构建出的树都与一次性解析相同
+TEST(TestPushParser, PushParser)
+{
+	const char *texts[] = {
+		"null", " true ", "false", "0", "-12.5e+3", "123456789012345678901234567890", "\"\"", "\"abc\"",
+		"\"\\\"\\\\\\/\\b\\f\\n\\r\\t\\u0041\\uD834\\uDD1E\"", "[]", "{}", " [ ] ", "[1,[2,[3,{}]],\"x\"]",
+		"{\"a\":1,\"b\":[true,false,null],\"c\":{\"d\":\"e\\n\"},\"\":\"\"}",
+		// 非法的输入
+		"", "  ", "nul", "nulx", "nullx", "?", "+1", "01", "1.", "1e", "1-2", "1e309", "\"abc", "\"\\x\"", "\"\\u12\"",
+		"\"\\uD800\"", "\"\\uD800\\u0041\"", "\"a\x01\"", "[", "[1", "[1,", "[1,]", "[1 2]", "[1}", "[nullnull]",
+		"{", "{\"a\"", "{\"a\":", "{\"a\":1", "{\"a\" 1}", "{1:1}", "{\"a\":1,}", "{\"a\":1]", "{\"\\x\":1}", "1 2", "[[]]]",
+	};
+	for (const char *text : texts) {
+		std::string s = text;
+		yfn::Json expect;
+		json::ParseResult whole = expect.try_parse(s);
+		for (size_t chunk : { size_t(1), size_t(2), size_t(3), size_t(7), size_t(64) }) {
+			yfn::Json j;
+			j.set_number(42);
+			json::PushParser parser(j);
+			json::ParseResult result{ json::ParseOk, 0 };
+			for (size_t i = 0; i < s.size() && result.code == json::ParseOk; i += chunk)
+				result = parser.feed(s.data() + i, std::min(chunk, s.size() - i));
+			if (result.code == json::ParseOk)
+				result = parser.finish();
+			EXPECT_EQ(whole.code, result.code) << text << " / " << chunk;
+			EXPECT_EQ(whole.offset, result.offset) << text << " / " << chunk;
+			EXPECT_EQ(1, int(j == expect)) << text << " / " << chunk;
+		}
+	}
+
+	// 深度限制与事件的停止
+	json::ParseOptions options;
+	options.max_depth = 2;
+	json::Handler ignore;
+	json::PushParser limited(ignore, options);
+	EXPECT_EQ(json::ParseOk, limited.feed("[[").code);
+	EXPECT_EQ(json::ParseDepthExceeded, limited.feed("[1]]]").code);
+	EXPECT_EQ(json::ParseDepthExceeded, limited.finish().code);
+	EXPECT_EQ(2u, limited.finish().offset);
+	limited.reset();
+	EXPECT_EQ(json::ParseOk, limited.feed("[[1]").code);
+	EXPECT_EQ(json::ParseOk, limited.feed("]").code);
+	EXPECT_EQ(json::ParseOk, limited.finish().code);
+
+	EventRecorder stop;
+	stop.stop_after = 3;
+	json::PushParser cancelled(stop);
+	EXPECT_EQ(json::ParseOk, cancelled.feed("{\"a\"").code);
+	EXPECT_EQ(json::ParseCancelled, cancelled.feed(":[1,2]}").code);
+	EXPECT_EQ("{ k:a [", stop.events);
+
+	// 严格校验 UTF-8：key 与字符串中的错误在任意位置分块时都与一次性解析相同
+	json::ParseOptions strict;
+	strict.validate_utf8 = true;
+	for (const char *text : { "{\"k\xC0\xAF" "0\":0}", "{\"a\":1,\"\xE2\x82\":2}", "[\"ok\",\"x\xED\xA0\x80\"]", "{\"\xC3\xA9\":\"\xF0\x9F\x98\x80\"}" }) {
+		std::string s = text;
+		yfn::Json expect;
+		json::ParseResult whole = expect.try_parse(s, strict);
+		for (size_t split = 0; split <= s.size(); ++split) {
+			yfn::Json j;
+			json::PushParser parser(j, strict);
+			json::ParseResult result = parser.feed(s.data(), split);
+			if (result.code == json::ParseOk)
+				result = parser.feed(s.data() + split, s.size() - split);
+			if (result.code == json::ParseOk)
+				result = parser.finish();
+			EXPECT_EQ(whole.code, result.code) << text << " / " << split;
+			EXPECT_EQ(whole.offset, result.offset) << text << " / " << split;
+			EXPECT_EQ(1, int(j == expect)) << text << " / " << split;
+		}
+	}
+
+	// 跨越块边界的长字符串
+	EventRecorder r;
+	json::PushParser streaming(r);
+	std::string big(10000, 'x');
+	std::string text = "[\"" + big + "\\n\"," + "12345" + "]";
+	for (size_t i = 0; i < text.size(); i += 1000)
+		EXPECT_EQ(json::ParseOk, streaming.feed(text.substr(i, 1000)).code);
+	EXPECT_EQ(json::ParseOk, streaming.finish().code);
+	EXPECT_EQ("[ s:" + big + "\n #12345 ]2", r.events);
+}
+
+// 测试并行解析 JSON Lines：不同的线程数与批次大小得到相同的、按顺序排列的记录
+TEST(TestParseLines, ParseLines)
+{
+	std::string content;
+	std::vector<std::string> lines;
+	for (int i = 0; i < 500; ++i) {
+		std::string line = "{\"id\":" + std::to_string(i) + ",\"tags\":[\"a\",\"b\\n\"],\"ok\":" + (i % 2 ? "true" : "false") + "}";
+		lines.push_back(line);
+		content += line + (i % 3 == 0 ? "\r\n" : "\n");
+		if (i % 50 == 0)
+			content += "   \n\n";	// 空行被忽略
+	}
+	for (size_t threads : { size_t(1), size_t(2), size_t(4), size_t(0) }) {
+		for (size_t batch : { size_t(1), size_t(100), size_t(4096), size_t(1) << 20 }) {
+			json::LinesOptions options;
+			options.threads = threads;
+			options.batch_bytes = batch;
+			std::vector<yfn::Json> records;
+			json::ParseResult result = json::parse_lines(content, records, options);
+			EXPECT_EQ(json::ParseOk, result.code);
+			EXPECT_EQ(content.size(), result.offset);
+			ASSERT_EQ(lines.size(), records.size());
+			for (size_t i = 0; i < lines.size(); i += 37) {
+				yfn::Json expect;
+				expect.parse(lines[i]);
+				EXPECT_EQ(1, int(records[i] == expect));
+			}
+
+			size_t next = 0;
+			bool ordered = true;
+			result = json::parse_lines(content, [&](size_t index, yfn::JsonView record) {
+				ordered = ordered && index == next && record.get_object_value(0).get_number() == double(next);
+				++next;
+				return true;
+			}, options);
+			EXPECT_EQ(json::ParseOk, result.code);
+			EXPECT_TRUE(ordered);
+			EXPECT_EQ(lines.size(), next);
+		}
+	}
+
+	// 出错的记录之前的记录都已交出，偏移相对于整个输入
+	std::string bad = "[1]\n[2]\n[3,]\n[4]\n";
+	for (size_t threads : { size_t(1), size_t(3) }) {
+		json::LinesOptions options;
+		options.threads = threads;
+		options.batch_bytes = 1;
+		std::vector<yfn::Json> records;
+		json::ParseResult result = json::parse_lines(bad, records, options);
+		EXPECT_EQ(json::ParseInvalidValue, result.code);
+		EXPECT_EQ(11u, result.offset);
+		EXPECT_EQ(2u, records.size());
+
+		size_t seen = 0;
+		result = json::parse_lines(content, [&](size_t, yfn::JsonView) { return ++seen < 10; }, options);
+		EXPECT_EQ(json::ParseCancelled, result.code);
+		EXPECT_EQ(content.find(lines[9]), result.offset);
+		EXPECT_EQ(10u, seen);
+	}
+
+	// SAX：事件在调用线程中按顺序交出，与逐行调用 json::parse 得到的事件完全相同
+	struct LineRecorder : json::RecordHandler
+	{
+		EventRecorder events;
+		std::vector<size_t> offsets;
+		size_t stop_at = size_t(-1);
+		bool on_record(size_t offset) override { offsets.push_back(offset); return offsets.size() != stop_at; }
+		bool on_null() override { return events.on_null(); }
+		bool on_bool(bool b) override { return events.on_bool(b); }
+		bool on_number(double d) override { return events.on_number(d); }
+		bool on_string(std::string_view s) override { return events.on_string(s); }
+		bool on_key(std::string_view k) override { return events.on_key(k); }
+		bool on_start_object() override { return events.on_start_object(); }
+		bool on_end_object(size_t n) override { return events.on_end_object(n); }
+		bool on_start_array() override { return events.on_start_array(); }
+		bool on_end_array(size_t n) override { return events.on_end_array(n); }
+	};
+	const std::thread::id caller = std::this_thread::get_id();
+	struct ThreadCheck : json::RecordHandler
+	{
+		std::thread::id caller;
+		bool same = true;
+		bool on_record(size_t) override { same = same && std::this_thread::get_id() == caller; return true; }
+	};
+	auto sequential = [](const std::string &text, LineRecorder &r) {
+		size_t pos = 0;
+		while (pos < text.size()) {
+			size_t nl = std::min(text.find('\n', pos), text.size());
+			std::string line = text.substr(pos, nl - pos);
+			if (line.find_first_not_of(" \t\r") != std::string::npos) {
+				r.on_record(pos);
+				json::ParseResult res = json::parse(line, r);
+				if (res.code != json::ParseOk)
+					return json::ParseResult{ res.code, pos + res.offset };
+			}
+			pos = nl + 1;
+		}
+		return json::ParseResult{ json::ParseOk, text.size() };
+	};
+	for (const std::string &text : { content, bad }) {
+		LineRecorder expect;
+		json::ParseResult expect_result = sequential(text, expect);
+		for (size_t threads : { size_t(1), size_t(4) }) {
+			for (size_t batch : { size_t(1), size_t(512), size_t(1) << 20 }) {
+				json::LinesOptions options;
+				options.threads = threads;
+				options.batch_bytes = batch;
+				LineRecorder r;
+				json::ParseResult result = json::parse_lines(text, r, options);
+				EXPECT_EQ(expect_result.code, result.code) << threads << " / " << batch;
+				EXPECT_EQ(expect_result.offset, result.offset) << threads << " / " << batch;
+				EXPECT_EQ(expect.offsets, r.offsets) << threads << " / " << batch;
+				EXPECT_EQ(expect.events.events, r.events.events) << threads << " / " << batch;
+
+				ThreadCheck check;
+				check.caller = caller;
+				json::parse_lines(text, check, options);
+				EXPECT_TRUE(check.same);
+
+				// 在第 3 条记录处停止：偏移为该记录的开头，之后不再有任何事件
+				LineRecorder stop;
+				stop.stop_at = 3;
+				result = json::parse_lines(text, stop, options);
+				EXPECT_EQ(json::ParseCancelled, result.code);
+				ASSERT_EQ(3u, stop.offsets.size());
+				EXPECT_EQ(stop.offsets[2], result.offset);
+				EXPECT_EQ(0u, expect.events.events.find(stop.events.events));
+			}
+		}
+	}
+}
+
+// 替换全局的 operator new：fail_allocations_above 不为 0 时，超过该字节数的申请抛出 std::bad_alloc，用于测试工作线程中的异常
+static std::atomic<size_t> fail_allocations_above{ 0 };
+
+void* operator new(size_t size)
+{
+	size_t limit = fail_allocations_above.load(std::memory_order_relaxed);
+	if (limit != 0 && size > limit)
+		throw std::bad_alloc();
+	if (void *p = std::malloc(size == 0 ? 1 : size))
+		return p;
+	throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	size_t limit = fail_allocations_above.load(std::memory_order_relaxed);
+	if (limit != 0 && size > limit)
+		return nullptr;
+	return std::malloc(size == 0 ? 1 : size);
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+// 工作线程中抛出的异常在交出该批次时于调用线程中重新抛出，与单线程时相同，进程不会终止
+TEST(TestParseLinesException, ParseLinesException)
+{
+	// 每个批次有 20 万条记录，保存记录或事件的 vector 扩容时申请的内存超过 1 MB
+	std::string content;
+	for (int i = 0; i < 400000; ++i)
+		content += "0\n";
+	struct Ignore : json::RecordHandler { };
+	for (size_t threads : { size_t(1), size_t(2), size_t(4) }) {
+		json::LinesOptions options;
+		options.threads = threads;
+		options.batch_bytes = 400000;
+		std::vector<yfn::Json> records;
+		Ignore ignore;
+		fail_allocations_above = 1 << 20;
+		EXPECT_THROW(json::parse_lines(content, records, options), std::bad_alloc) << threads;
+		EXPECT_THROW(json::parse_lines(content, [](size_t, yfn::JsonView) { return true; }, options), std::bad_alloc) << threads;
+		EXPECT_THROW(json::parse_lines(content, ignore, options), std::bad_alloc) << threads;
+		fail_allocations_above = 0;
+		EXPECT_EQ(json::ParseOk, json::parse_lines(content, ignore, options).code);
+	}
+}
+
+TEST(TestParseFile, ParseFile) {
+	// 通过 /proc/self/fd 得到临时文件的路径
+	auto write_file = [](std::FILE *file, const std::string &content) {
+		std::rewind(file);
+		EXPECT_EQ(0, ftruncate(fileno(file), 0));
+		EXPECT_EQ(content.size(), std::fwrite(content.data(), 1, content.size(), file));
+		std::fflush(file);
+		return "/proc/self/fd/" + std::to_string(fileno(file));
+	};
+	std::FILE *file = std::tmpfile();
+	ASSERT_NE(nullptr, file);
+
+	std::string text = "{\"name\":\"mini\\njson\",\"list\":[1,2.5,true,null],\"empty\":{}}";
+	std::string path = write_file(file, text);
+	Json j;
+	j.parse_file(path);
+	Json expect;
+	expect.parse(text);
+	EXPECT_TRUE(j == expect);
+	yfn::Document doc;
+	EXPECT_EQ(json::ParseOk, doc.parse_file(path).code);
+	EXPECT_TRUE(doc.view() == expect.view());
+
+	// 超过大页提示阈值的文件，文件结尾恰好没有多余的字节
+	std::string big = "[";
+	while (big.size() < 3 * 1024 * 1024)
+		big += "\"abcdefghijklmnopqrstuvwxyz\",12345.678,";
+	big += "0]";
+	path = write_file(file, big);
+	json::ParseResult result = j.try_parse_file(path);
+	EXPECT_EQ(json::ParseOk, result.code);
+	EXPECT_EQ(big.size(), result.offset);
+	EXPECT_EQ(big.size(), doc.parse_file(path).offset);
+
+	// 解析错误的偏移与解析内存中的文本一致
+	path = write_file(file, "[1,2,");
+	result = j.try_parse_file(path);
+	EXPECT_EQ(json::ParseExpectValue, result.code);
+	EXPECT_EQ(5u, result.offset);
+	EXPECT_EQ(json::Null, j.get_type());
+	path = write_file(file, "");
+	EXPECT_EQ(json::ParseExpectValue, j.try_parse_file(path).code);
+	std::fclose(file);
+
+	// 文件不存在
+	result = j.try_parse_file("/nonexistent/mini.json");
+	EXPECT_EQ(json::ParseFileError, result.code);
+	EXPECT_STREQ("parse file error", json::error_message(result.code));
+	EXPECT_EQ(json::ParseFileError, doc.parse_file("/nonexistent/mini.json").code);
+	EXPECT_EQ(json::Null, doc.view().get_type());
+	try {
+		j.parse_file("/nonexistent/mini.json");
+		FAIL();
+	} catch (const json::Exception &e) {
+		EXPECT_EQ(json::ParseFileError, e.code());
+	}
+}
+
+// 结构索引引擎：与逐字符解析的结果、事件、错误码与出错位置完全相同，输入的各个部分分别落在 64 字节块的不同位置
+TEST(TestStructuralEngine, StructuralEngine)
+{
+	json::ParseOptions scalar, structural;
+	scalar.engine = json::ParseEngine::Scalar;
+	structural.engine = json::ParseEngine::Structural;
+	auto compare = [&](const std::string &s) {
+		yfn::Json expect, j;
+		json::ParseResult a = expect.try_parse(s, scalar);
+		json::ParseResult b = j.try_parse(s, structural);
+		EXPECT_EQ(a.code, b.code) << s;
+		EXPECT_EQ(a.offset, b.offset) << s;
+		EXPECT_TRUE(j == expect) << s;
+		EventRecorder ra, rb;
+		rb.input_begin = s.data();
+		rb.input_end = s.data() + s.size();
+		json::parse(s, ra, scalar);
+		json::parse(s, rb, structural);
+		// 出错时两者同样在出错之前停止产生事件（重新定位错误用的 Reader 不产生事件），因此事件总是相同
+		EXPECT_EQ(ra.events, rb.events) << s;
+		return a.code == json::ParseOk;
+	};
+
+	const char *texts[] = {
+		"null", " true ", "false", "0", "-12.5e+3", "123456789012345678901234567890", "\"\"", "\"abc\"",
+		"\"\\\"\\\\\\/\\b\\f\\n\\r\\t\\u0041\\uD834\\uDD1E\"", "[]", "{}", " [ ] ", "[1,[2,[3,{}]],\"x\"]",
+		"{\"a\":1,\"b\":[true,false,null],\"c\":{\"d\":\"e\\n\"},\"\":\"\"}", "[\"\\\\\",\"\\\\\\\"\",\"]\",\"{\\\"}\"]",
+		"", "  ", "nul", "nulx", "nullx", "?", "+1", "01", "1.", "1e", "1-2", "1e309", "\"abc", "\"\\x\"", "\"\\u12\"",
+		"\"\\uD800\"", "\"\\uD800\\u0041\"", "\"a\x01\"", "[", "[1", "[1,", "[1,]", "[1 2]", "[1}", "[nullnull]",
+		"{", "{\"a\"", "{\"a\":", "{\"a\":1", "{\"a\" 1}", "{1:1}", "{\"a\":1,}", "{\"a\":1]", "{\"\\x\":1}", "1 2", "[[]]]",
+		"[\"a\"\"b\"]", "[\"a\"x]", "{\"a\"x:1}", "[1]x", "\\\"", "[\\\"]", "{\"a\":1 \"b\":2}", "[,]", "[:]", "{,}", "{\"a\"::1}",
+	};
+	for (const char *text : texts) {
+		for (size_t pad = 0; pad < 70; ++pad) {
+			compare(std::string(pad, ' ') + text);
+			compare("[" + std::string(pad, ' ') + text + "]");
+		}
+	}
+
+	// 跨越块边界的连续反斜杠
+	for (size_t pad = 0; pad < 140; ++pad) {
+		for (size_t slashes = 0; slashes < 5; ++slashes) {
+			std::string esc;
+			for (size_t i = 0; i < slashes; ++i)
+				esc += "\\\\";
+			EXPECT_TRUE(compare("[\"" + std::string(pad, 'a') + esc + "\\\"\", 1]"));
+			compare("[\"" + std::string(pad, 'a') + esc + "\\\", 1]");
+		}
+	}
+
+	// 随机的输入，大多数不合法
+	const char alphabet[] = "\"\\[]{},:  \n0123456789-.eEtrufalsn";
+	unsigned seed = 12345;
+	auto random = [&]() { seed = seed * 1103515245 + 12345; return (seed >> 16) & 0x7FFF; };
+	for (int t = 0; t < 3000; ++t) {
+		std::string s;
+		size_t len = random() % 200;
+		for (size_t i = 0; i < len; ++i)
+			s += alphabet[random() % (sizeof(alphabet) - 1)];
+		compare(s);
+	}
+
+	// 较长的合法输入、中途停止的位置与深度限制
+	std::string big = "{\"list\":[";
+	for (int i = 0; i < 300; ++i)
+		big += "{\"id\":" + std::to_string(i) + ",\"name\":\"n\\\\" + std::to_string(i) + "\",\"ok\":true,\"v\":[1.5,null]},\n";
+	big += "{}]}";
+	EXPECT_TRUE(compare(big));
+	for (size_t stop = 1; stop < 40; ++stop) {
+		EventRecorder ra, rb;
+		ra.stop_after = rb.stop_after = stop;
+		json::ParseResult a = json::parse(big, ra, scalar);
+		json::ParseResult b = json::parse(big, rb, structural);
+		EXPECT_EQ(json::ParseCancelled, b.code);
+		EXPECT_EQ(a.offset, b.offset);
+		EXPECT_EQ(ra.events, rb.events);
+	}
+	scalar.max_depth = structural.max_depth = 2;
+	compare("[[1],[2]]");
+	compare("[[[1]]]");
+	compare("{\"a\":{\"b\":{}}}");
+}
+
+// 每个可用的 SIMD 级别的解析与生成结果都与 scalar 相同：特殊字节与空白落在 64/32/16 字节块中的每个位置
+TEST(TestSimdDispatch, SimdDispatch)
+{
+	const std::string original = json::simd_level();
+	EXPECT_FALSE(json::set_simd_level("unknown"));
+	ASSERT_TRUE(json::set_simd_level("scalar"));
+	EXPECT_STREQ("scalar", json::simd_level());
+
+	std::vector<std::string> texts;
+	for (size_t pos = 0; pos < 140; ++pos) {
+		std::string a(pos, 'a'), b(140 - pos, 'b');
+		texts.push_back("[\"" + a + "\\n" + b + "\",\"" + a + "\\\\\\\"" + b + "\",\"" + a + "\"]");
+		texts.push_back("[\"" + a + "\x01" + b + "\"]");
+		texts.push_back("[\"" + a + b + "\"]");
+		texts.push_back("{" + std::string(pos, ' ') + "\"k\"" + std::string(pos, '\n') + ":" + std::string(pos, '\t') + "1}");
+		texts.push_back("[1,\n" + std::string(pos, ' ') + "x]");
+	}
+	json::ParseOptions scalar, structural;
+	scalar.engine = json::ParseEngine::Scalar;
+	structural.engine = json::ParseEngine::Structural;
+	struct Expected
+	{
+		json::ParseResult result;
+		std::string out;
+	};
+	std::vector<Expected> expected;
+	for (const std::string &s : texts) {
+		yfn::Json j;
+		Expected e{ j.try_parse(s, scalar), std::string() };
+		j.stringify(e.out);
+		expected.push_back(e);
+	}
+
+	for (const char *level : { "sse2", "sse4.2", "avx2", "avx512" }) {
+		if (!json::set_simd_level(level))
+			continue;
+		EXPECT_STREQ(level, json::simd_level());
+		for (size_t i = 0; i < texts.size(); ++i) {
+			for (const json::ParseOptions &options : { scalar, structural }) {
+				yfn::Json j;
+				json::ParseResult r = j.try_parse(texts[i], options);
+				EXPECT_EQ(expected[i].result.code, r.code) << level << ": " << texts[i];
+				EXPECT_EQ(expected[i].result.offset, r.offset) << level << ": " << texts[i];
+				std::string out;
+				j.stringify(out);
+				EXPECT_EQ(expected[i].out, out) << level << ": " << texts[i];
+			}
+		}
+	}
+	EXPECT_TRUE(json::set_simd_level(original.c_str()));
+}
+
+TEST(TestValidateUtf8, ValidateUtf8)
+{
+	const std::string original = json::simd_level();
+	// 合法的序列：2、3、4 字节的边界值
+	const char *valid[] = { "\xC2\x80", "\xDF\xBF", "\xE0\xA0\x80", "\xE2\x82\xAC", "\xED\x9F\xBF", "\xEE\x80\x80", "\xEF\xBF\xBF",
+		"\xF0\x90\x80\x80", "\xF0\x9F\x98\x80", "\xF4\x8F\xBF\xBF" };
+	// 不合法的序列：过长的编码、代理项、大于 U+10FFFF、多余或缺少的 10xxxxxx、不会出现的字节
+	const char *invalid[] = { "\xC0\x80", "\xC1\xBF", "\xE0\x9F\xBF", "\xED\xA0\x80", "\xED\xBF\xBF", "\xF0\x8F\xBF\xBF",
+		"\xF4\x90\x80\x80", "\xF5\x80\x80\x80", "\xFF", "\x80", "\xBF", "\xC3", "\xC3" "a", "\xE2\x82", "\xE2\x82" "a",
+		"\xF0\x9F\x98", "\xF0\x9F" "a", "\xE2\x82\xAC\x80" };
+
+	std::vector<std::string> levels;
+	for (const char *level : { "scalar", "sse2", "sse4.2", "avx2", "avx512" }) {
+		if (json::set_simd_level(level))
+			levels.push_back(level);
+	}
+	for (const std::string &level : levels) {
+		ASSERT_TRUE(json::set_simd_level(level.c_str()));
+		EXPECT_EQ(json::ParseOk, json::validate_utf8("").code);
+		// 序列出现在各个块中的各个位置，前后都是 ASCII 或者合法的多字节字符
+		for (size_t pos = 0; pos < 140; ++pos) {
+			for (const std::string &filler : { std::string("a"), std::string("\xC3\xA9") }) {
+				std::string prefix, suffix;
+				while (prefix.size() < pos) prefix += filler;
+				while (suffix.size() < 140 - pos) suffix += filler;
+				for (const char *s : valid) {
+					std::string text = prefix + s + suffix;
+					json::ParseResult r = json::validate_utf8(text);
+					EXPECT_EQ(json::ParseOk, r.code) << level << ": " << pos;
+					EXPECT_EQ(text.size(), r.offset) << level << ": " << pos;
+				}
+				for (const char *s : invalid) {
+					std::string text = prefix + s + suffix;
+					json::ParseResult r = json::validate_utf8(text);
+					EXPECT_EQ(json::ParseInvalidUtf8, r.code) << level << ": " << pos;
+					EXPECT_EQ(prefix.size() + (std::string(s) == "\xE2\x82\xAC\x80" ? 3 : 0), r.offset) << level << ": " << pos;
+					// 结尾处不完整的序列
+					text = prefix + s;
+					r = json::validate_utf8(text);
+					EXPECT_EQ(json::ParseInvalidUtf8, r.code) << level << ": " << pos;
+				}
+			}
+		}
+	}
+
+	// 随机的字节：各个级别的结果都与 scalar 相同
+	unsigned seed = 12345;
+	auto next = [&seed]() { seed = seed * 1103515245 + 12345; return (seed >> 16) & 0x7FFF; };
+	for (int round = 0; round < 2000; ++round) {
+		std::string text;
+		size_t len = next() % 300;
+		while (text.size() < len) {
+			switch (next() % 4) {
+			case 0: text += static_cast<char>(next() & 0x7F); break;
+			case 1: text += valid[next() % (sizeof(valid) / sizeof(valid[0]))]; break;
+			case 2: text += "\xC3\xA9\xE4\xB8\xAD"; break;
+			default: if (next() % 8 == 0) text += static_cast<char>(next() & 0xFF); break;
+			}
+		}
+		ASSERT_TRUE(json::set_simd_level("scalar"));
+		json::ParseResult expected = json::validate_utf8(text);
+		for (const std::string &level : levels) {
+			ASSERT_TRUE(json::set_simd_level(level.c_str()));
+			json::ParseResult r = json::validate_utf8(text);
+			EXPECT_EQ(expected.code, r.code) << level << ": " << round;
+			EXPECT_EQ(expected.offset, r.offset) << level << ": " << round;
+		}
+	}
+	EXPECT_TRUE(json::set_simd_level(original.c_str()));
+
+	// 默认不校验；开启之后字符串（包括 key 与含转义的字符串）中的错误都报告在不合法的序列的第一个字节
+	json::ParseOptions strict;
+	strict.validate_utf8 = true;
+	yfn::Json j;
+	EXPECT_EQ(json::ParseOk, j.try_parse("[\"a\xFF\"]").code);
+	struct Case
+	{
+		std::string text;
+		size_t offset;
+	};
+	const Case cases[] = {
+		{ "[\"a\xFF\"]", 3 },
+		{ "[\"\xE2\x82\xAC\\n\xED\xA0\x80\"]", 7 },
+		{ "{\"k\xC0\x80\":1}", 3 },
+		{ "{\"k\":\"" + std::string(100, 'x') + "\xE2\x82\"}", 106 },
+	};
+	for (json::ParseEngine engine : { json::ParseEngine::Scalar, json::ParseEngine::Structural }) {
+		strict.engine = engine;
+		for (const Case &c : cases) {
+			json::ParseResult r = j.try_parse(c.text, strict);
+			EXPECT_EQ(json::ParseInvalidUtf8, r.code) << c.text;
+			EXPECT_EQ(c.offset, r.offset) << c.text;
+			EXPECT_EQ(json::Null, j.get_type());
+		}
+		// 在不合法的序列之前的语法错误照常报告
+		EXPECT_EQ(json::ParseMissCommaOrSquareBracket, j.try_parse("[1x,\"\xFF\"]", strict).code);
+		EXPECT_EQ(json::ParseInvalidValue, j.try_parse("[\xC3\xA9]", strict).code);
+		// 输入按 64 KB 的窗口校验：多字节字符跨过窗口的边界，以及之后的窗口中的错误
+		for (size_t pad = 65530; pad < 65540; ++pad) {
+			std::string big = "[\"" + std::string(pad, 'x') + "\xF0\x9F\x98\x80\",\"" + std::string(70000, 'y') + "\"]";
+			EXPECT_EQ(json::ParseOk, j.try_parse(big, strict).code) << pad;
+			big.insert(big.size() - 2, "\xED\xA0\x80");
+			json::ParseResult r = j.try_parse(big, strict);
+			EXPECT_EQ(json::ParseInvalidUtf8, r.code) << pad;
+			EXPECT_EQ(big.size() - 5, r.offset) << pad;
+		}
+		ASSERT_EQ(json::ParseOk, j.try_parse("{\"\xE4\xB8\xAD\":[\"\xF0\x9F\x98\x80\\t\xC3\xA9\"]}", strict).code);
+		EXPECT_EQ("\xE4\xB8\xAD", j.get_object_key(0));
+		EXPECT_EQ("\xF0\x9F\x98\x80\t\xC3\xA9", j.get_object_value(0).get_array_element(0).get_string());
+	}
+	EXPECT_STREQ("parse invalid utf8", json::error_message(json::ParseInvalidUtf8));
+}